@@ -0,0 +1,477 @@
+/**
+ * File: benchmark.cpp
+ * -------------------
+ * Presents a command-line program that measures how quickly the N-Queens
+ * and SuDoKu solvers run, without any animation.  Usage:
+ *
+ *     benchmark [-json] [-warmup n] [-reps n] [-queens low high]
+ *               [-corpus file] [-only suite]
+ *
+ * Each benchmark is run -warmup times untimed (2 by default), to warm the
+ * caches and the branch predictors, and then -reps times under a stopwatch
+ * (5 by default).  The wall time is summarized by its minimum, median, mean,
+ * and standard deviation, and the rates are computed from the median.  The
+ * benchmarks are grouped into suites:
+ *
+ *     queens-first  finds one solution for each dimension from low to high
+ *                   (4 to 16 by default)
+ *     queens-count  counts every solution for each of those dimensions
+ *     queens-batch-scalar, queens-batch-avx2
+ *                   count every solution for each of those dimensions with
+ *                   a QueensBatchCounter using the named engine (the avx2
+ *                   suite is skipped on processors without AVX2)
+ *     sudoku        solves every puzzle in the corpus (sudoku-corpus.txt
+ *                   in this directory, by default)
+ *     sudoku-dlx    solves the same puzzles as exact cover problems using
+ *                   dancing links
+ *     sudoku-unique checks that each of the same puzzles has a unique
+ *                   solution, counting solutions up to a limit of 2
+ *     sudoku-kernel-scalar, sudoku-kernel-avx2
+ *                   solves the same puzzles with a SuDoKuKernel using the
+ *                   named engine (the avx2 suite is skipped on processors
+ *                   without AVX2), and reports guesses as their nodes
+ *
+ * and -only restricts the run to one of them.  The node and backtrack counts
+ * come from one more, observed, run of each benchmark, so that the timed runs
+ * are exactly what the solvers do when nobody is watching.  Results are
+ * printed as a table, or, given -json, as a JSON document suitable for
+ * comparing one release against the next.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "queens-batch.h"
+#include "queens-bitboard.h"
+#include "queens-constants.h"
+#include "queens-counter.h"
+#include "queens-observers.h"
+#include "stopwatch.h"
+#include "sudoku-board.h"
+#include "sudoku-exact-cover.h"
+#include "sudoku-kernel.h"
+#include "sudoku-observers.h"
+#include "sudoku-solver.h"
+using namespace std;
+
+#ifndef BENCHMARK_DIR
+#define BENCHMARK_DIR "."
+#endif
+
+/* Constants */
+static const int kDefaultWarmupRuns = 2;
+static const int kDefaultTimedRuns = 5;
+static const int kDefaultLowDimension = 4;
+static const int kDefaultHighDimension = 16;
+static const string kDefaultCorpus = string(BENCHMARK_DIR) + "/sudoku-corpus.txt";
+
+/**
+ * Type: Benchmark
+ * ---------------
+ * Describes one benchmark.  run performs the work being timed and returns
+ * the number of solutions found, and observe performs the same work while
+ * counting the nodes visited and the backtracks taken.
+ */
+struct Benchmark {
+    string suite;
+    int size;                                         // the dimension, or the number of puzzles
+    function<uint64_t()> run;
+    function<void(uint64_t& numNodes, uint64_t& numBacktracks)> observe;
+};
+
+/**
+ * Type: Summary
+ * -------------
+ * Summarizes the wall times of the timed runs, in seconds.
+ */
+struct Summary {
+    double min;
+    double median;
+    double mean;
+    double stddev;
+};
+
+/**
+ * Type: Result
+ * ------------
+ * Records everything measured about one benchmark.
+ */
+struct Result {
+    const Benchmark *benchmark;
+    uint64_t numSolutions;
+    uint64_t numNodes;
+    uint64_t numBacktracks;
+    Summary seconds;
+};
+
+/**
+ * Function: printUsage
+ * --------------------
+ * Explains how the program is meant to be invoked.
+ */
+static void printUsage(const string& program) {
+    cerr << "Usage: " << program << " [-json] [-warmup n] [-reps n] [-queens low high]"
+         << " [-corpus file] [-only suite]" << endl;
+}
+
+/**
+ * Function: summarize
+ * -------------------
+ * Computes the summary statistics of the provided (nonempty) list of times.
+ */
+static Summary summarize(vector<double> times) {
+    sort(times.begin(), times.end());
+    size_t count = times.size();
+    Summary summary;
+    summary.min = times[0];
+    summary.median = count % 2 == 1 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2;
+    double sum = 0;
+    for (double time: times) sum += time;
+    summary.mean = sum / count;
+    double squares = 0;
+    for (double time: times) squares += (time - summary.mean) * (time - summary.mean);
+    summary.stddev = count > 1 ? sqrt(squares / (count - 1)) : 0;
+    return summary;
+}
+
+/**
+ * Function: measure
+ * -----------------
+ * Runs the provided benchmark the specified number of times without timing
+ * it, then the specified number of times with timing, and finally once more
+ * to count its nodes and backtracks.
+ */
+static Result measure(const Benchmark& benchmark, int numWarmupRuns, int numTimedRuns) {
+    Result result;
+    result.benchmark = &benchmark;
+    result.numSolutions = 0;
+    for (int i = 0; i < numWarmupRuns; i++) result.numSolutions = benchmark.run();
+
+    vector<double> times;
+    for (int i = 0; i < numTimedRuns; i++) {
+        Stopwatch stopwatch;
+        result.numSolutions = benchmark.run();
+        times.push_back(stopwatch.getElapsedSeconds());
+    }
+    result.seconds = summarize(times);
+    benchmark.observe(result.numNodes, result.numBacktracks);
+    return result;
+}
+
+/**
+ * Function: addQueensBenchmarks
+ * -----------------------------
+ * Adds the benchmarks in the queens suites.  Counting exhausts the search
+ * tree, so every placement is eventually undone and the backtrack count of
+ * a count is simply its node count.
+ */
+static void addQueensBenchmarks(vector<Benchmark>& benchmarks, int low, int high) {
+    for (int dimension = low; dimension <= high; dimension++) {
+        Benchmark first;
+        first.suite = "queens-first";
+        first.size = dimension;
+        first.run = [dimension]() -> uint64_t {
+            QueensBitboard solver(dimension);
+            return solver.solve() ? 1 : 0;
+        };
+        first.observe = [dimension](uint64_t& numNodes, uint64_t& numBacktracks) {
+            QueensBitboard solver(dimension);
+            CountingQueensObserver observer;
+            solver.solve(observer);
+            numNodes = observer.numPlaced;
+            numBacktracks = observer.numRemoved;
+        };
+        benchmarks.push_back(first);
+    }
+
+    for (int dimension = low; dimension <= high; dimension++) {
+        Benchmark count;
+        count.suite = "queens-count";
+        count.size = dimension;
+        count.run = [dimension]() -> uint64_t {
+            QueensCounter counter(dimension);
+            counter.count();
+            return counter.getTotalCount();
+        };
+        count.observe = [dimension](uint64_t& numNodes, uint64_t& numBacktracks) {
+            QueensCounter counter(dimension);
+            counter.count();
+            numNodes = numBacktracks = counter.getNodeCount();
+        };
+        benchmarks.push_back(count);
+    }
+
+    QueensBatchEngine engines[] = { kScalarEngine, kAVX2Engine };
+    for (QueensBatchEngine engine: engines) {
+        if (!QueensBatchCounter::isEngineSupported(engine)) continue;
+        for (int dimension = low; dimension <= high; dimension++) {
+            Benchmark batch;
+            batch.suite = string("queens-batch-") + QueensBatchCounter::getEngineName(engine);
+            batch.size = dimension;
+            batch.run = [dimension, engine]() -> uint64_t {
+                QueensBatchCounter counter(dimension, engine);
+                counter.count();
+                return counter.getTotalCount();
+            };
+            batch.observe = [dimension, engine](uint64_t& numNodes, uint64_t& numBacktracks) {
+                QueensBatchCounter counter(dimension, engine);
+                counter.count();
+                numNodes = numBacktracks = counter.getNodeCount();
+            };
+            benchmarks.push_back(batch);
+        }
+    }
+}
+
+/**
+ * Function: solveCorpus
+ * ---------------------
+ * Solves a fresh copy of every puzzle in the corpus, reporting every step
+ * to the provided observer, and returns the number solved.  The puzzles
+ * are solved with dancing links if withDancingLinks is true, and by the
+ * backtracking search otherwise.
+ */
+template <typename Observer>
+static uint64_t solveCorpus(const vector<SuDoKuBoard>& puzzles, Observer& observer, bool withDancingLinks) {
+    SuDoKuExactCover dlx;
+    uint64_t numSolved = 0;
+    for (const SuDoKuBoard& puzzle: puzzles) {
+        SuDoKuBoard board = puzzle;
+        if (withDancingLinks ? dlx.solve(observer, board) : solve(observer, board)) numSolved++;
+    }
+    return numSolved;
+}
+
+/**
+ * Function: solveCorpusWithKernel
+ * -------------------------------
+ * Solves a fresh copy of every puzzle in the corpus with a SuDoKuKernel
+ * using the provided engine, totals the kernel's node counts in numNodes,
+ * and returns the number solved.
+ */
+static uint64_t solveCorpusWithKernel(const vector<SuDoKuBoard>& puzzles, SuDoKuKernelEngine engine,
+                                      uint64_t& numNodes) {
+    SuDoKuKernel kernel(engine);
+    uint64_t numSolved = 0;
+    numNodes = 0;
+    for (const SuDoKuBoard& puzzle: puzzles) {
+        SuDoKuBoard board = puzzle;
+        if (kernel.solve(board)) numSolved++;
+        numNodes += kernel.getNodeCount();
+    }
+    return numSolved;
+}
+
+/**
+ * Function: countUniqueInCorpus
+ * -----------------------------
+ * Counts the solutions to every puzzle in the corpus, up to a limit of 2,
+ * reporting every step to the provided observer, and returns the number
+ * with a unique solution.
+ */
+template <typename Observer>
+static uint64_t countUniqueInCorpus(const vector<SuDoKuBoard>& puzzles, Observer& observer) {
+    uint64_t numUnique = 0;
+    for (const SuDoKuBoard& puzzle: puzzles) {
+        SuDoKuBoard board = puzzle;
+        if (countSolutions(observer, board, 2) == 1) numUnique++;
+    }
+    return numUnique;
+}
+
+/**
+ * Function: addSuDoKuBenchmark
+ * ----------------------------
+ * Loads the corpus, one 81-character puzzle per line, and adds the
+ * benchmarks that solve it, one per solver, along with the one that checks
+ * it for uniqueness.  Returns false if the corpus can't be read.
+ */
+static bool addSuDoKuBenchmark(vector<Benchmark>& benchmarks, const string& filename) {
+    ifstream in(filename.c_str());
+    if (!in) {
+        cerr << "Could not open " << filename << endl;
+        return false;
+    }
+
+    vector<SuDoKuBoard> puzzles;
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty()) continue;
+        SuDoKuBoard board;
+        if (!board.load(line)) {
+            cerr << "Skipping invalid puzzle " << line << endl;
+            continue;
+        }
+        puzzles.push_back(board);
+    }
+
+    for (bool withDancingLinks: { false, true }) {
+        Benchmark benchmark;
+        benchmark.suite = withDancingLinks ? "sudoku-dlx" : "sudoku";
+        benchmark.size = puzzles.size();
+        benchmark.run = [puzzles, withDancingLinks]() {
+            NullSuDoKuObserver observer;
+            return solveCorpus(puzzles, observer, withDancingLinks);
+        };
+        benchmark.observe = [puzzles, withDancingLinks](uint64_t& numNodes, uint64_t& numBacktracks) {
+            CountingSuDoKuObserver observer;
+            solveCorpus(puzzles, observer, withDancingLinks);
+            numNodes = observer.numPlaced;
+            numBacktracks = observer.numLifted;
+        };
+        benchmarks.push_back(benchmark);
+    }
+
+    SuDoKuKernelEngine engines[] = { kScalarKernel, kAVX2Kernel };
+    for (SuDoKuKernelEngine engine: engines) {
+        if (!SuDoKuKernel::isEngineSupported(engine)) continue;
+        Benchmark kernel;
+        kernel.suite = string("sudoku-kernel-") + SuDoKuKernel::getEngineName(engine);
+        kernel.size = puzzles.size();
+        kernel.run = [puzzles, engine]() {
+            uint64_t numNodes;
+            return solveCorpusWithKernel(puzzles, engine, numNodes);
+        };
+        kernel.observe = [puzzles, engine](uint64_t& numNodes, uint64_t& numBacktracks) {
+            solveCorpusWithKernel(puzzles, engine, numNodes);
+            numBacktracks = 0;
+        };
+        benchmarks.push_back(kernel);
+    }
+
+    Benchmark unique;
+    unique.suite = "sudoku-unique";
+    unique.size = puzzles.size();
+    unique.run = [puzzles]() {
+        NullSuDoKuObserver observer;
+        return countUniqueInCorpus(puzzles, observer);
+    };
+    unique.observe = [puzzles](uint64_t& numNodes, uint64_t& numBacktracks) {
+        CountingSuDoKuObserver observer;
+        countUniqueInCorpus(puzzles, observer);
+        numNodes = observer.numPlaced;
+        numBacktracks = observer.numLifted;
+    };
+    benchmarks.push_back(unique);
+    return true;
+}
+
+/**
+ * Function: perSecond
+ * -------------------
+ * Returns the rate at which count things happened in the provided time,
+ * taking care not to divide by zero for runs too short to measure.
+ */
+static double perSecond(uint64_t count, double seconds) {
+    return seconds > 0 ? count / seconds : 0;
+}
+
+/**
+ * Function: printTable
+ * --------------------
+ * Prints one line per result, in a form meant for people.
+ */
+static void printTable(const vector<Result>& results) {
+    cout << "suite                 size      solutions          nodes     backtracks"
+         << "   median (s)   stddev (s)      nodes/s  solutions/s" << endl;
+    for (const Result& result: results) {
+        char line[256];
+        snprintf(line, sizeof line, "%-20s %5d %14llu %14llu %14llu %12.6f %12.6f %12.4g %12.4g",
+                 result.benchmark->suite.c_str(), result.benchmark->size,
+                 (unsigned long long) result.numSolutions, (unsigned long long) result.numNodes,
+                 (unsigned long long) result.numBacktracks, result.seconds.median, result.seconds.stddev,
+                 perSecond(result.numNodes, result.seconds.median),
+                 perSecond(result.numSolutions, result.seconds.median));
+        cout << line << endl;
+    }
+}
+
+/**
+ * Function: printJSON
+ * -------------------
+ * Prints the results as a JSON document, in a form meant for scripts.
+ * (No string printed needs escaping, so none is done.)
+ */
+static void printJSON(const vector<Result>& results, int numWarmupRuns, int numTimedRuns) {
+    cout.precision(9);
+    cout << "{" << endl;
+    cout << "  \"warmupRuns\": " << numWarmupRuns << "," << endl;
+    cout << "  \"timedRuns\": " << numTimedRuns << "," << endl;
+    cout << "  \"results\": [" << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        cout << "    {" << endl;
+        cout << "      \"suite\": \"" << result.benchmark->suite << "\"," << endl;
+        cout << "      \"size\": " << result.benchmark->size << "," << endl;
+        cout << "      \"solutions\": " << result.numSolutions << "," << endl;
+        cout << "      \"nodes\": " << result.numNodes << "," << endl;
+        cout << "      \"backtracks\": " << result.numBacktracks << "," << endl;
+        cout << "      \"seconds\": { \"min\": " << result.seconds.min << ", \"median\": " << result.seconds.median
+             << ", \"mean\": " << result.seconds.mean << ", \"stddev\": " << result.seconds.stddev << " }," << endl;
+        cout << "      \"nodesPerSecond\": " << perSecond(result.numNodes, result.seconds.median) << "," << endl;
+        cout << "      \"solutionsPerSecond\": " << perSecond(result.numSolutions, result.seconds.median) << endl;
+        cout << "    }" << (i + 1 < results.size() ? "," : "") << endl;
+    }
+    cout << "  ]" << endl;
+    cout << "}" << endl;
+}
+
+/**
+ * Function: main
+ * --------------
+ * Defines the entry point of the program, which processes the flags,
+ * runs every benchmark selected, and prints the results.
+ */
+int main(int argc, char *argv[]) {
+    bool asJSON = false;
+    int numWarmupRuns = kDefaultWarmupRuns, numTimedRuns = kDefaultTimedRuns;
+    int low = kDefaultLowDimension, high = kDefaultHighDimension;
+    string corpus = kDefaultCorpus, only;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-json") {
+            asJSON = true;
+        } else if (arg == "-warmup" && i + 1 < argc) {
+            numWarmupRuns = atoi(argv[++i]);
+        } else if (arg == "-reps" && i + 1 < argc) {
+            numTimedRuns = atoi(argv[++i]);
+        } else if (arg == "-queens" && i + 2 < argc) {
+            low = atoi(argv[++i]);
+            high = atoi(argv[++i]);
+        } else if (arg == "-corpus" && i + 1 < argc) {
+            corpus = argv[++i];
+        } else if (arg == "-only" && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (numWarmupRuns < 0 || numTimedRuns < 1 || low < 1 || high > kMaxBitboardDimension) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    vector<Benchmark> benchmarks;
+    addQueensBenchmarks(benchmarks, low, high);
+    bool wantSuDoKu = only.empty() || only.compare(0, 6, "sudoku") == 0;
+    if (wantSuDoKu && !addSuDoKuBenchmark(benchmarks, corpus)) return 1;
+
+    vector<Result> results;
+    for (const Benchmark& benchmark: benchmarks) {
+        if (!only.empty() && benchmark.suite != only) continue;
+        cerr << "Running " << benchmark.suite << " " << benchmark.size << "..." << endl;
+        results.push_back(measure(benchmark, numWarmupRuns, numTimedRuns));
+    }
+
+    if (asJSON) printJSON(results, numWarmupRuns, numTimedRuns);
+    else printTable(results);
+    return 0;
+}
@@ -0,0 +1,71 @@
+# Qt Creator project file for the solver benchmarks
+#
+# Builds a command-line program that times the N-Queens and SuDoKu
+# searches and reports how much work they do.  Like the headless solvers,
+# it compiles only the solver sources from ../solve-queens/src and
+# ../solve-sudoku/src and the code in ../shared, leaving the Stanford C++
+# library out entirely, so it can be run from scripts and batch jobs.
+
+TEMPLATE = app
+TARGET = benchmark
+CONFIG += console
+CONFIG -= qt
+CONFIG -= app_bundle
+CONFIG += warn_off
+CONFIG += c++11
+
+SOURCES *= $$PWD/benchmark.cpp
+SOURCES *= $$PWD/../shared/exact-cover.cpp
+SOURCES *= $$PWD/../solve-queens/src/queens-batch.cpp
+SOURCES *= $$PWD/../solve-queens/src/queens-bitboard.cpp
+SOURCES *= $$PWD/../solve-queens/src/queens-counter.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-board.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-exact-cover.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-kernel.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-rules.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-solver.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-stats.cpp
+SOURCES *= $$PWD/../solve-sudoku/src/sudoku-strategy.cpp
+
+HEADERS *= $$PWD/../shared/backtracking.h
+HEADERS *= $$PWD/../shared/exact-cover.h
+HEADERS *= $$PWD/../shared/parallel-backtracking.h
+HEADERS *= $$PWD/../shared/stopwatch.h
+HEADERS *= $$PWD/../shared/work-stealing-deque.h
+HEADERS *= $$PWD/../solve-queens/src/queens-batch.h
+HEADERS *= $$PWD/../solve-queens/src/queens-bitboard.h
+HEADERS *= $$PWD/../solve-queens/src/queens-constants.h
+HEADERS *= $$PWD/../solve-queens/src/queens-counter.h
+HEADERS *= $$PWD/../solve-queens/src/queens-observers.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-board.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-constants.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-exact-cover.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-kernel.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-observers.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-rules.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-solver.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-stats.h
+HEADERS *= $$PWD/../solve-sudoku/src/sudoku-strategy.h
+
+OTHER_FILES *= $$PWD/sudoku-corpus.txt
+
+INCLUDEPATH *= $$PWD/../shared/
+INCLUDEPATH *= $$PWD/../solve-queens/src/
+INCLUDEPATH *= $$PWD/../solve-sudoku/src/
+
+# lets the program find sudoku-corpus.txt wherever it's built
+DEFINES += BENCHMARK_DIR=\\\"$$PWD\\\"
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Werror=return-type
+QMAKE_CXXFLAGS += -Werror=uninitialized
+QMAKE_CXXFLAGS += -Wno-sign-compare
+
+!win32 {
+    LIBS += -lpthread
+}
+
+CONFIG(release, debug|release) {
+    QMAKE_CXXFLAGS += -O3
+}
@@ -0,0 +1,246 @@
+/**
+ * File: backtracking.h
+ * --------------------
+ * Defines the Backtracker class template, the recursive backtracking
+ * search that the N-Queens and SuDoKu solvers are both built on.  The
+ * search itself knows nothing about either puzzle: it chooses a variable,
+ * tries each of its values in turn, and undoes whatever didn't work, so
+ * that every improvement made to it reaches every puzzle at once.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Class: NullBacktrackingObserver
+ * -------------------------------
+ * Ignores everything the search reports.  A Backtracker's observer can be
+ * any class with these methods:
+ *
+ *     void enterNode();                       the search has reached a new node
+ *     void applyValue(variable, value);       the value is being tried
+ *     void retractValue(variable, value);     it has been taken back
+ *     void keepValue(variable, value);        it's part of the solution found
+ *     void recordSolution();                  every variable has a value
+ *
+ * Because the calls are resolved at compile time, the empty methods here
+ * compile away to nothing, and an unobserved search runs exactly as if it
+ * had no hooks at all.
+ */
+class NullBacktrackingObserver {
+public:
+    void enterNode() {}
+    template <typename Variable, typename Value>
+    void applyValue(const Variable&, const Value&) {}
+    template <typename Variable, typename Value>
+    void retractValue(const Variable&, const Value&) {}
+    template <typename Variable, typename Value>
+    void keepValue(const Variable&, const Value&) {}
+    void recordSolution() {}
+};
+
+/**
+ * Class: Backtracker
+ * ------------------
+ * Searches for assignments of values to the variables of a problem that
+ * satisfy all of its constraints.  The problem can be any class that
+ * defines the types Variable, Value, Values (the values a variable has
+ * left to try), and Trail (the undo stack, usually a std::vector of
+ * changes, though anything with a size method will do), along with these
+ * methods:
+ *
+ *     bool propagate(Trail& trail);
+ *                                     deduce what the values so far force,
+ *                                     pushing every change onto the trail;
+ *                                     return false on a contradiction
+ *     bool chooseVariable(Variable& variable);
+ *                                     pick the next variable to branch on;
+ *                                     return false if every one has a value
+ *     Values getValues(const Variable& variable);
+ *     bool nextValue(Values& values, Value& value);
+ *                                     list the variable's values, and take
+ *                                     the next one to try from the list
+ *     void apply(const Variable& variable, const Value& value, Trail& trail);
+ *                                     give the variable the value, pushing
+ *                                     every change onto the trail
+ *     void undo(Trail& trail, size_t size);
+ *                                     pop changes off the trail, undoing
+ *                                     each, until only size of them remain
+ *     void keep(const Trail& trail, size_t first, size_t last);
+ *                                     the changes from first up to last are
+ *                                     part of the solution found
+ *
+ * All of the problem's state that the search changes has to be recorded
+ * on the trail, which is the only undo stack there is.  Backtracking to a
+ * node hands the problem the size the trail had there, and the problem
+ * is left to undo its changes however it likes, one at a time or all at
+ * once.  The problem propagates once on entering each node, before it
+ * chooses a variable, and problems with nothing to propagate just return
+ * true.
+ *
+ * A search runs in one of three modes.  findFirst stops at the first
+ * solution and leaves it in place, with its changes still on the trail;
+ * findAll hands every solution to a listener; and count just counts them.
+ * The last two leave the problem and the trail as they found them.
+ */
+template <typename Problem, typename Observer = NullBacktrackingObserver>
+class Backtracker {
+public:
+    typedef typename Problem::Variable Variable;
+    typedef typename Problem::Value Value;
+    typedef typename Problem::Values Values;
+    typedef typename Problem::Trail Trail;
+
+    /**
+     * Constructor: Backtracker
+     * ------------------------
+     * Constructs a search of the provided problem that records its changes
+     * on the provided trail and reports to a copy of the provided observer.
+     * The problem and the trail must outlive the search, and the trail can
+     * already hold changes, which the search never undoes.
+     */
+    Backtracker(Problem& problem, Trail& trail, const Observer& observer = Observer()) :
+        problem(problem), trail(trail), observer(observer), numNodes(0), numSolutions(0), limit(0) {}
+
+    /**
+     * Method: findFirst
+     * -----------------
+     * Searches for a solution, returning true if and only if one was found,
+     * in which case it's left in place.  Otherwise the problem and the trail
+     * are left as they were.
+     */
+    bool findFirst();
+
+    /**
+     * Method: findAll
+     * ---------------
+     * Hands the problem to the listener, which can be any function or
+     * function object that takes a const Problem&, each time every variable
+     * has a value, stopping once limit solutions have been found if limit
+     * isn't 0.  Returns the number of solutions found.
+     */
+    template <typename Listener>
+    uint64_t findAll(Listener listener, uint64_t limit = 0);
+
+    /**
+     * Method: count
+     * -------------
+     * Counts the solutions, stopping once limit of them have been found if
+     * limit isn't 0, and returns the count.
+     */
+    uint64_t count(uint64_t limit = 0);
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of values tried over every search so far.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+    /**
+     * Method: getObserver
+     * -------------------
+     * Returns the search's copy of the observer.
+     */
+    Observer& getObserver() { return observer; }
+
+private:
+    Problem& problem;
+    Trail& trail;
+    Observer observer;
+    uint64_t numNodes;
+    uint64_t numSolutions;
+    uint64_t limit;
+
+    struct IgnoreSolutions {
+        void operator()(const Problem&) const {}
+    };
+
+    template <bool kStopAtFirst, typename Listener>
+    bool search(Listener& listener);
+};
+
+/*
+ * Implementation notes: Backtracker templates
+ * -------------------------------------------
+ * search returns true once the whole search should stop, because it found
+ * the solution it was after or as many as it was allowed.  Each node
+ * remembers how long the trail was when it was entered, once it had
+ * propagated, and once it had applied a value, so undoing a value, or the
+ * whole node, is a matter of handing the problem one of those sizes.  When
+ * a first solution is found, each node on the way back up keeps the
+ * changes its value made and then the ones its propagation made, which
+ * reports the solution from the bottom of the tree up, just as the search
+ * unwinds.
+ */
+
+template <typename Problem, typename Observer>
+bool Backtracker<Problem, Observer>::findFirst() {
+    IgnoreSolutions listener;
+    return search<true>(listener);
+}
+
+template <typename Problem, typename Observer>
+template <typename Listener>
+uint64_t Backtracker<Problem, Observer>::findAll(Listener listener, uint64_t limit) {
+    numSolutions = 0;
+    this->limit = limit;
+    search<false>(listener);
+    return numSolutions;
+}
+
+template <typename Problem, typename Observer>
+uint64_t Backtracker<Problem, Observer>::count(uint64_t limit) {
+    return findAll(IgnoreSolutions(), limit);
+}
+
+template <typename Problem, typename Observer>
+template <bool kStopAtFirst, typename Listener>
+bool Backtracker<Problem, Observer>::search(Listener& listener) {
+    size_t entered = trail.size();
+    observer.enterNode();
+    if (!problem.propagate(trail)) {
+        problem.undo(trail, entered);
+        return false;
+    }
+
+    size_t propagated = trail.size();
+    Variable variable;
+    if (!problem.chooseVariable(variable)) {
+        observer.recordSolution();
+        if (kStopAtFirst) {
+            problem.keep(trail, entered, propagated);
+            return true;
+        }
+        listener(static_cast<const Problem&>(problem));
+        problem.undo(trail, entered);
+        return ++numSolutions == limit;
+    }
+
+    Values values = problem.getValues(variable);
+    Value value;
+    while (problem.nextValue(values, value)) {
+        problem.apply(variable, value, trail);
+        size_t applied = trail.size();
+        numNodes++;
+        observer.applyValue(variable, value);
+        bool isStopping = search<kStopAtFirst>(listener);
+        if (kStopAtFirst && isStopping) {
+            observer.keepValue(variable, value);
+            problem.keep(trail, propagated, applied);
+            problem.keep(trail, entered, propagated);
+            return true;
+        }
+        observer.retractValue(variable, value);
+        problem.undo(trail, propagated);
+        if (isStopping) {
+            problem.undo(trail, entered);
+            return true;
+        }
+    }
+
+    problem.undo(trail, entered);
+    return false;
+}
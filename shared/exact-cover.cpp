@@ -0,0 +1,162 @@
+/**
+ * File: exact-cover.cpp
+ * ---------------------
+ * Presents the implementation of the non-template methods of the
+ * ExactCover class.
+ */
+
+#include "exact-cover.h"
+using namespace std;
+
+/**
+ * Class: CallbackVisitor
+ * ----------------------
+ * Adapts a solution callback to the visitor interface expected by search.
+ */
+class CallbackVisitor {
+public:
+    CallbackVisitor(const function<bool(const vector<int>&)>& callback) : callback(callback) {}
+
+    void chooseRow(int) {}
+    void unchooseRow(int) {}
+    bool reportSolution(const vector<int>& rows) { return callback(rows); }
+
+private:
+    const function<bool(const vector<int>&)>& callback;
+};
+
+/**
+ * Implementation notes: constructor
+ * ---------------------------------
+ * Every column gets a header node, whose up and down links start out
+ * pointing at itself.  The primary headers are linked into a circular
+ * list through the root, which follows them; secondary headers link only
+ * to themselves, so the search never chooses them and never needs them
+ * covered, though covering one still removes the rows that intersect it.
+ */
+ExactCover::ExactCover(int numPrimaryColumns, int numSecondaryColumns) :
+    sizes(numPrimaryColumns + numSecondaryColumns, 0),
+    isSelected(numPrimaryColumns + numSecondaryColumns, false),
+    root(numPrimaryColumns + numSecondaryColumns),
+    numSolutions(0),
+    numNodes(0) {
+    for (int column = 0; column <= root; column++) {
+        Node header = { column, column, column, column, column, -1 };
+        if (column < numPrimaryColumns || column == root) {
+            header.left = column == 0 ? root : column - 1;
+            header.right = column == numPrimaryColumns - 1 ? root : column + 1;
+        }
+        nodes.push_back(header);
+    }
+    if (numPrimaryColumns == 0) {
+        nodes[root].left = nodes[root].right = root;
+    } else {
+        nodes[root].left = numPrimaryColumns - 1;
+        nodes[root].right = 0;
+    }
+}
+
+int ExactCover::addRow(const vector<int>& columns) {
+    int row = firstNodes.size();
+    int first = nodes.size();
+    firstNodes.push_back(first);
+    for (size_t i = 0; i < columns.size(); i++) {
+        int column = columns[i];
+        int node = nodes.size();
+        Node entry = { node - 1, node + 1, nodes[column].up, column, column, row };
+        if (i == 0) entry.left = first + columns.size() - 1;
+        if (i == columns.size() - 1) entry.right = first;
+        nodes.push_back(entry);
+        nodes[nodes[column].up].down = node;
+        nodes[column].up = node;
+        sizes[column]++;
+    }
+    return row;
+}
+
+bool ExactCover::selectRow(int row) {
+    int first = firstNodes[row];
+    int node = first;
+    do {
+        if (isSelected[nodes[node].column]) return false;
+        node = nodes[node].right;
+    } while (node != first);
+
+    do {
+        isSelected[nodes[node].column] = true;
+        cover(nodes[node].column);
+        node = nodes[node].right;
+    } while (node != first);
+    selected.push_back(row);
+    return true;
+}
+
+void ExactCover::clearSelection() {
+    while (!selected.empty()) {
+        int first = firstNodes[selected.back()];
+        int node = first;
+        do {
+            node = nodes[node].left;
+            uncover(nodes[node].column);
+            isSelected[nodes[node].column] = false;
+        } while (node != first);
+        selected.pop_back();
+    }
+}
+
+uint64_t ExactCover::solve(const function<bool(const vector<int>&)>& callback) {
+    CallbackVisitor visitor(callback);
+    return solve(visitor);
+}
+
+/**
+ * Methods: cover, uncover
+ * -----------------------
+ * cover unlinks the column's header from the list of headers, and then
+ * unlinks every row that intersects the column from every other column it
+ * covers.  The unlinked nodes keep their own links, which is all uncover
+ * needs to put them back, working in exactly the opposite order.
+ */
+void ExactCover::cover(int column) {
+    Node& header = nodes[column];
+    nodes[header.left].right = header.right;
+    nodes[header.right].left = header.left;
+    for (int node = header.down; node != column; node = nodes[node].down) {
+        for (int other = nodes[node].right; other != node; other = nodes[other].right) {
+            const Node& entry = nodes[other];
+            nodes[entry.up].down = entry.down;
+            nodes[entry.down].up = entry.up;
+            sizes[entry.column]--;
+        }
+    }
+}
+
+void ExactCover::uncover(int column) {
+    Node& header = nodes[column];
+    for (int node = header.up; node != column; node = nodes[node].up) {
+        for (int other = nodes[node].left; other != node; other = nodes[other].left) {
+            const Node& entry = nodes[other];
+            sizes[entry.column]++;
+            nodes[entry.up].down = other;
+            nodes[entry.down].up = other;
+        }
+    }
+    nodes[header.left].right = column;
+    nodes[header.right].left = column;
+}
+
+/**
+ * Method: chooseColumn
+ * --------------------
+ * Returns the uncovered primary column with the fewest rows, which keeps
+ * the search tree as narrow as possible near its root.  A column with no
+ * rows, or just one, can't be beaten, so the scan stops at the first.
+ */
+int ExactCover::chooseColumn() const {
+    int best = nodes[root].right;
+    for (int column = best; column != root; column = nodes[column].right) {
+        if (sizes[column] < sizes[best]) best = column;
+        if (sizes[best] <= 1) break;
+    }
+    return best;
+}
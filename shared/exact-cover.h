@@ -0,0 +1,171 @@
+/**
+ * File: exact-cover.h
+ * -------------------
+ * Defines the ExactCover class, which solves exact cover problems using
+ * Knuth's Algorithm X, implemented with dancing links.  An exact cover
+ * problem is a collection of rows, each of which covers some of the
+ * columns, and a solution is a set of rows that covers every primary
+ * column exactly once and every secondary column at most once.  Many
+ * puzzles (SuDoKu and N-Queens among them) are exact cover problems in
+ * disguise, so the one search here can stand in for a hand-written
+ * backtracker per puzzle.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Class: ExactCover
+ * -----------------
+ * Builds an exact cover problem one row at a time and then searches it.
+ * The 1s of the sparse matrix are kept as nodes in one contiguous array,
+ * each linked to its neighbors in its row and column by index rather than
+ * by pointer, so the links are half the size of pointers and the nodes of
+ * a row sit next to one another in memory.  Covering a column unlinks it
+ * and every row that intersects it; uncovering relinks them in the reverse
+ * order, which is the dancing that gives the links their name.  The search
+ * always branches on the primary column with the fewest remaining rows.
+ *
+ * The search reports to a visitor, which can be any class with these
+ * methods:
+ *
+ *     void chooseRow(int row);        a row has been added to the partial solution
+ *     void unchooseRow(int row);      the row has been taken back out
+ *     bool reportSolution(const std::vector<int>& rows);
+ *                                     every primary column is covered; return
+ *                                     true to keep searching, false to stop
+ */
+class ExactCover {
+public:
+
+    /**
+     * Constructor: ExactCover
+     * -----------------------
+     * Constructs a problem with no rows, where columns 0 through
+     * numPrimaryColumns - 1 are primary and the numSecondaryColumns after
+     * them are secondary.
+     */
+    ExactCover(int numPrimaryColumns, int numSecondaryColumns = 0);
+
+    /**
+     * Method: addRow
+     * --------------
+     * Adds a row covering the listed columns, of which there must be at
+     * least one and none listed twice, and returns its index.  Rows are
+     * numbered from 0 in the order they're added.
+     */
+    int addRow(const std::vector<int>& columns);
+
+    /**
+     * Method: selectRow
+     * -----------------
+     * Places the specified row in every solution, as with the digits given
+     * in a puzzle.  Returns false, without selecting it, if some row selected
+     * earlier already covers one of its columns.  Rows must be selected after
+     * every row has been added and before the search.
+     */
+    bool selectRow(int row);
+
+    /**
+     * Method: clearSelection
+     * ----------------------
+     * Undoes every call to selectRow, so that the same rows can be searched
+     * with different ones selected.
+     */
+    void clearSelection();
+
+    /**
+     * Method: solve
+     * -------------
+     * Searches for solutions, reporting each (selected rows included) until
+     * the callback returns false or the search runs out, and returns the
+     * number of solutions reported.  The second version reports every step
+     * of the search to the provided visitor instead.  Either way, the problem
+     * is left as it was, so it can be searched again.
+     */
+    uint64_t solve(const std::function<bool(const std::vector<int>&)>& callback);
+    template <typename Visitor>
+    uint64_t solve(Visitor& visitor);
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of rows chosen during the most recent search.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+private:
+    struct Node {
+        int left, right, up, down;
+        int column;                      // the header of this node's column
+        int row;                         // the row this node belongs to, or -1 for a header
+    };
+
+    std::vector<Node> nodes;             // column headers first, then the root, then the 1s
+    std::vector<int> sizes;              // sizes[column] is the number of rows still in it
+    std::vector<int> firstNodes;         // firstNodes[row] is the index of the row's first node
+    std::vector<char> isSelected;        // isSelected[column] is true if a selected row covers it
+    std::vector<int> selected;           // the rows selected in advance
+    std::vector<int> solution;           // the rows of the current partial solution
+    int root;
+    uint64_t numSolutions;
+    uint64_t numNodes;
+
+    void cover(int column);
+    void uncover(int column);
+    int chooseColumn() const;
+    template <typename Visitor>
+    bool search(Visitor& visitor);
+};
+
+/*
+ * Implementation notes: ExactCover templates
+ * ------------------------------------------
+ * search returns true once the visitor asks it to stop.  Whether it stops
+ * or not, every column it covers is uncovered on the way back up, so the
+ * links are restored no matter how the search ends.
+ */
+
+template <typename Visitor>
+uint64_t ExactCover::solve(Visitor& visitor) {
+    numSolutions = 0;
+    numNodes = 0;
+    solution = selected;
+    search(visitor);
+    solution.clear();
+    return numSolutions;
+}
+
+template <typename Visitor>
+bool ExactCover::search(Visitor& visitor) {
+    if (nodes[root].right == root) {
+        numSolutions++;
+        return !visitor.reportSolution(solution);
+    }
+
+    int column = chooseColumn();
+    if (sizes[column] == 0) return false;
+
+    bool stop = false;
+    cover(column);
+    for (int node = nodes[column].down; node != column && !stop; node = nodes[node].down) {
+        int row = nodes[node].row;
+        numNodes++;
+        solution.push_back(row);
+        for (int other = nodes[node].right; other != node; other = nodes[other].right) {
+            cover(nodes[other].column);
+        }
+        visitor.chooseRow(row);
+        stop = search(visitor);
+        if (!stop) visitor.unchooseRow(row);
+        for (int other = nodes[node].left; other != node; other = nodes[other].left) {
+            uncover(nodes[other].column);
+        }
+        solution.pop_back();
+    }
+    uncover(column);
+    return stop;
+}
@@ -0,0 +1,74 @@
+/**
+ * File: mapped-file.cpp
+ * ---------------------
+ * Presents the implementation of the MappedFile class.
+ */
+
+#include <fstream>
+#include "mapped-file.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+MappedFile::MappedFile(const string& filename) :
+    data(NULL),
+    size(0),
+    mapped(false),
+    open(false) {
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        if (info.st_size == 0) {
+            open = true;
+        } else {
+            void *mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const uint8_t *>(mapping);
+                size = info.st_size;
+                mapped = open = true;
+            }
+        }
+    }
+    ::close(fd);
+#else
+    ifstream in(filename.c_str(), ios::binary | ios::ate);
+    if (!in) return;
+    size = in.tellg();
+    if (size == 0) {
+        open = true;
+        return;
+    }
+    uint8_t *contents = new uint8_t[size];
+    in.seekg(0);
+    if (in.read(reinterpret_cast<char *>(contents), size)) {
+        data = contents;
+        open = true;
+    } else {
+        delete[] contents;
+        size = 0;
+    }
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (data != NULL) {
+#ifndef _WIN32
+        if (mapped) munmap(const_cast<uint8_t *>(data), size);
+#else
+        delete[] data;
+#endif
+    }
+    data = NULL;
+    size = 0;
+    mapped = open = false;
+}
@@ -0,0 +1,64 @@
+/**
+ * File: mapped-file.h
+ * -------------------
+ * Defines the MappedFile class, which makes the contents of a file
+ * available as one read-only block of memory.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Class: MappedFile
+ * -----------------
+ * Maps a file into memory where the platform allows it, so that its pages
+ * are read on demand straight from the operating system's cache, and reads
+ * the whole file into memory otherwise.  Either way, the contents stay put
+ * until the MappedFile is closed or destroyed.
+ */
+class MappedFile {
+public:
+
+    /**
+     * Constructor: MappedFile
+     * -----------------------
+     * Opens and maps the named file.  Use isOpen to confirm that it could be.
+     */
+    MappedFile(const std::string& filename);
+
+    /**
+     * Destructor: ~MappedFile
+     * -----------------------
+     * Unmaps the file.
+     */
+    ~MappedFile();
+
+    /**
+     * Methods: isOpen, getData, getSize
+     * ---------------------------------
+     * Report whether the file could be mapped and, if so, where its contents
+     * are and how many bytes there are.  An empty file is open, with no data.
+     */
+    bool isOpen() const { return open; }
+    const uint8_t *getData() const { return data; }
+    size_t getSize() const { return size; }
+
+    /**
+     * Method: close
+     * -------------
+     * Unmaps the file, after which it's no longer open.
+     */
+    void close();
+
+private:
+    const uint8_t *data;
+    size_t size;
+    bool mapped;
+    bool open;
+
+    MappedFile(const MappedFile&);                // not copyable
+    MappedFile& operator=(const MappedFile&);
+};
@@ -0,0 +1,588 @@
+/**
+ * File: parallel-backtracking.h
+ * -----------------------------
+ * Defines the ParallelBacktracker class template, which runs the same
+ * search as a Backtracker (see backtracking.h) on several threads at once.
+ * Any problem a Backtracker can search can be searched in parallel, with
+ * no parallel code of its own: each thread searches its own copy of the
+ * problem, and work moves between threads as paths of choices, which are
+ * all it takes to rebuild a node on another copy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "backtracking.h"
+#include "work-stealing-deque.h"
+
+/**
+ * Class: ParallelBacktracker
+ * --------------------------
+ * Searches a problem with one thread per copy of it.  Each thread keeps a
+ * WorkStealingDeque of tasks, each of them a subtree named by the path of
+ * values that leads to it from the root.  A thread that runs out of tasks
+ * steals the oldest one from another thread, and while any thread is idle,
+ * busy threads hand over the untried values of their shallowest open node
+ * as new tasks, so the tree is split only as finely as the idle threads
+ * need.  Taking a task means replaying its path, propagating and applying
+ * each value in turn, which calls for problems that propagate and apply
+ * the same way every time.
+ *
+ * The three modes are the Backtracker's.  findFirst cancels every thread
+ * as soon as one finds a solution, and count and findAll cancel them once
+ * the limit is reached.  By default the solutions found are whichever
+ * ones the threads happen to reach first.  With deterministic ordering,
+ * they're the ones a Backtracker would have found, in the order it would
+ * have found them: threads only give up subtrees that come after the
+ * solutions already in hand, and the solutions are handed over once the
+ * search is done.  That holds as long as the problem chooses its variables
+ * and orders their values by its state alone.
+ */
+template <typename Problem, typename Observer = NullBacktrackingObserver>
+class ParallelBacktracker {
+public:
+    typedef typename Problem::Variable Variable;
+    typedef typename Problem::Value Value;
+    typedef typename Problem::Values Values;
+    typedef typename Problem::Trail Trail;
+
+    /**
+     * Constructor: ParallelBacktracker
+     * --------------------------------
+     * Constructs a search with one thread for each of the provided
+     * problems, which must all start out the same, and with one copy of
+     * the observer each.  The problems must outlive the search.
+     */
+    ParallelBacktracker(const std::vector<Problem *>& problems, const Observer& observer = Observer());
+
+    /**
+     * Method: setDeterministic
+     * ------------------------
+     * Chooses whether the solutions found are the ones a Backtracker would
+     * find, in the order it would find them.  They aren't by default.
+     */
+    void setDeterministic(bool isDeterministic) { this->isDeterministic = isDeterministic; }
+
+    /**
+     * Method: setThreadExitHook
+     * -------------------------
+     * Arranges for each thread to call the provided function just before it
+     * exits, which is the time to publish anything it kept in thread-local
+     * storage.
+     */
+    void setThreadExitHook(const std::function<void()>& hook) { threadExitHook = hook; }
+
+    /**
+     * Method: findFirst
+     * -----------------
+     * Searches for a solution, returning true if and only if one was found,
+     * in which case it's left in place in the first problem, with its
+     * changes on that problem's trail.  Every other problem is left as it
+     * was.
+     */
+    bool findFirst();
+
+    /**
+     * Method: findAll
+     * ---------------
+     * Hands each solution to the listener, as a Backtracker does, stopping
+     * once limit solutions have been found if limit isn't 0, and returns the
+     * number found.  The listener is only ever called by one thread at a
+     * time.  With deterministic ordering, the solutions are rebuilt in the
+     * first problem once the search is done and handed over from there.
+     */
+    template <typename Listener>
+    uint64_t findAll(Listener listener, uint64_t limit = 0);
+
+    /**
+     * Method: count
+     * -------------
+     * Counts the solutions, stopping once limit of them have been found if
+     * limit isn't 0, and returns the count.
+     */
+    uint64_t count(uint64_t limit = 0);
+
+    /**
+     * Methods: getNumThreads, getNodeCount, getObserver
+     * -------------------------------------------------
+     * Return the number of threads, the number of values tried by all of
+     * them over every search so far, and the observer of one of them.
+     */
+    int getNumThreads() const { return workers.size(); }
+    uint64_t getNodeCount() const;
+    Observer& getObserver(int thread) { return workers[thread]->observer; }
+
+private:
+    struct Step {
+        Variable variable;
+        Value value;
+        int index;          // the value's position among the variable's values
+    };
+
+    struct Task {
+        std::vector<Step> path;
+    };
+
+    struct Level {
+        Variable variable;
+        Values values;
+        Value value;        // the value being tried
+        int index;          // its position among the variable's values
+        int numTaken;       // values taken from values, by search or to hand over
+    };
+
+    struct Worker {
+        Problem *problem;
+        Trail trail;
+        Observer observer;
+        WorkStealingDeque<Task *> tasks;
+        std::vector<Step> prefix;       // the path to the task being searched
+        std::vector<Level *> levels;    // the open nodes below it, kept by search
+        std::vector<Step> bound;        // a copy of the bound as of boundVersion
+        std::vector<char> isOnBound;    // isOnBound[d] if path and bound agree for d steps
+        uint64_t boundVersion;
+        uint64_t numNodes;
+
+        Worker(Problem *problem, const Observer& observer) :
+            problem(problem), trail(), observer(observer), boundVersion(0), numNodes(0) {}
+    };
+
+    enum Mode { kFindFirst, kFindAll, kCount };
+
+    std::vector<std::unique_ptr<Worker> > workers;
+    bool isDeterministic;
+    std::function<void()> threadExitHook;
+
+    Mode mode;
+    uint64_t limit;
+    std::function<void(const Problem&)> listener;
+    std::atomic<bool> stop;
+    std::atomic<int64_t> numPending;
+    std::atomic<int> numIdle;
+    std::atomic<uint64_t> numFound;
+    std::mutex idleLock;
+    std::condition_variable idleSignal;
+    std::atomic<uint64_t> workVersion;   // bumped under idleLock whenever idle threads should look again
+    std::mutex solutionsLock;
+    std::vector<std::vector<Step> > solutions;
+    std::vector<Step> bound;
+    std::atomic<uint64_t> boundVersion;
+
+    uint64_t run(Mode mode, uint64_t limit);
+    void work(Worker& worker, int self);
+    Task *findTask(Worker& worker, int self);
+    void runTask(Worker& worker, const Task& task);
+    bool search(Worker& worker);
+    bool recordSolution(Worker& worker);
+    void donate(Worker& worker);
+    void wakeIdle();
+    bool isPastBound(Worker& worker);
+    static std::vector<Step> getPath(const Worker& worker, size_t depth);
+    static int getIndex(const Worker& worker, size_t depth);
+    bool replay(Worker& worker, const std::vector<Step>& path);
+    static bool precedes(const std::vector<Step>& one, const std::vector<Step>& two);
+};
+
+/*
+ * Implementation notes: ParallelBacktracker templates
+ * ---------------------------------------------------
+ * numPending counts the tasks made but not yet finished, so the search is
+ * over once it reaches 0: a task can only be made by a thread that's in
+ * the middle of another.  The root of the tree is the one task there is
+ * to begin with.  Each thread undoes everything once it finishes a task,
+ * so that its problem is back at the root for the next one, and the
+ * solutions kept for findFirst and the deterministic findAll are paths,
+ * which are replayed in the first problem once every thread has stopped.
+ * A thread that finds no task sleeps until a task is donated, the search
+ * ends, or a millisecond passes, whichever comes first, the last in case a
+ * steal lost a race for a task that's still there.
+ *
+ * Under deterministic ordering, the bound is the last of the limit
+ * earliest solutions found so far, once there are that many, and nothing
+ * that comes after it in the order a Backtracker searches needs to be
+ * searched at all.  Paths are ordered by the positions of their values,
+ * and a node comes after the bound if its path leaves the bound's for a
+ * later value.  Each thread tracks which prefixes of its path agree with
+ * the bound, so checking a node costs one comparison, and a thread whose
+ * node comes after the bound abandons its whole task, since everything
+ * left in it comes later still.  With a limit, the solutions are kept in
+ * a heap whose top is the latest of them, and so the bound; without one,
+ * they're simply collected, and sorted once the search is over.
+ */
+
+template <typename Problem, typename Observer>
+ParallelBacktracker<Problem, Observer>::ParallelBacktracker(const std::vector<Problem *>& problems,
+                                                           const Observer& observer) :
+    isDeterministic(false), mode(kFindFirst), limit(0), stop(false), numPending(0), numIdle(0), numFound(0),
+    workVersion(0), boundVersion(0) {
+    for (Problem *problem: problems) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker(problem, observer)));
+    }
+}
+
+template <typename Problem, typename Observer>
+bool ParallelBacktracker<Problem, Observer>::findFirst() {
+    listener = nullptr;
+    run(kFindFirst, 1);
+    if (solutions.empty()) return false;
+    Worker& first = *workers[0];
+    replay(first, solutions[0]);
+    first.problem->propagate(first.trail);
+    first.problem->keep(first.trail, 0, first.trail.size());
+    return true;
+}
+
+template <typename Problem, typename Observer>
+template <typename Listener>
+uint64_t ParallelBacktracker<Problem, Observer>::findAll(Listener listener, uint64_t limit) {
+    this->listener = listener;
+    uint64_t numSolutions = run(kFindAll, limit);
+    if (!isDeterministic) return numSolutions;
+
+    if (limit == 0) std::sort(solutions.begin(), solutions.end(), precedes);
+    else std::sort_heap(solutions.begin(), solutions.end(), precedes);
+    Worker& first = *workers[0];
+    for (const std::vector<Step>& path: solutions) {
+        replay(first, path);
+        first.problem->propagate(first.trail);
+        listener(static_cast<const Problem&>(*first.problem));
+        first.problem->undo(first.trail, 0);
+    }
+    return solutions.size();
+}
+
+template <typename Problem, typename Observer>
+uint64_t ParallelBacktracker<Problem, Observer>::count(uint64_t limit) {
+    listener = nullptr;
+    return run(kCount, limit);
+}
+
+template <typename Problem, typename Observer>
+uint64_t ParallelBacktracker<Problem, Observer>::getNodeCount() const {
+    uint64_t numNodes = 0;
+    for (const std::unique_ptr<Worker>& worker: workers) {
+        numNodes += worker->numNodes;
+    }
+    return numNodes;
+}
+
+template <typename Problem, typename Observer>
+uint64_t ParallelBacktracker<Problem, Observer>::run(Mode mode, uint64_t limit) {
+    this->mode = mode;
+    this->limit = limit;
+    stop = false;
+    numIdle = 0;
+    numFound = 0;
+    solutions.clear();
+    bound.clear();
+    boundVersion = 0;
+    for (const std::unique_ptr<Worker>& worker: workers) {
+        worker->boundVersion = 0;
+    }
+
+    numPending = 1;
+    workers[0]->tasks.push(new Task());
+    std::vector<std::thread> threads;
+    for (size_t self = 0; self < workers.size(); self++) {
+        threads.push_back(std::thread([this, self]() {
+            work(*workers[self], self);
+            if (threadExitHook) threadExitHook();
+        }));
+    }
+    for (std::thread& t: threads) t.join();
+
+    for (const std::unique_ptr<Worker>& worker: workers) {
+        Task *task;
+        while (worker->tasks.take(task)) delete task;
+    }
+    uint64_t numSolutions = numFound;
+    return limit != 0 ? std::min(numSolutions, limit) : numSolutions;
+}
+
+/**
+ * Method: work
+ * ------------
+ * Runs the provided thread's share of the search: the tasks it takes from
+ * its own deque or steals from others, until no task is left anywhere or
+ * the search has been stopped.
+ */
+template <typename Problem, typename Observer>
+void ParallelBacktracker<Problem, Observer>::work(Worker& worker, int self) {
+    bool isIdle = false;
+    while (numPending.load(std::memory_order_acquire) > 0 && !stop.load(std::memory_order_relaxed)) {
+        uint64_t seen = workVersion.load(std::memory_order_acquire);
+        Task *task = findTask(worker, self);
+        if (task == NULL) {
+            if (!isIdle) numIdle++;
+            isIdle = true;
+            std::unique_lock<std::mutex> lock(idleLock);
+            idleSignal.wait_for(lock, std::chrono::milliseconds(1), [this, seen]() {
+                return workVersion.load(std::memory_order_relaxed) != seen || numPending.load() == 0 || stop.load();
+            });
+            continue;
+        }
+
+        if (isIdle) numIdle--;
+        isIdle = false;
+        runTask(worker, *task);
+        delete task;
+        if (--numPending == 0) wakeIdle();
+    }
+    if (isIdle) numIdle--;
+}
+
+template <typename Problem, typename Observer>
+typename ParallelBacktracker<Problem, Observer>::Task *
+ParallelBacktracker<Problem, Observer>::findTask(Worker& worker, int self) {
+    Task *task;
+    if (worker.tasks.take(task)) return task;
+    for (size_t offset = 1; offset < workers.size(); offset++) {
+        if (workers[(self + offset) % workers.size()]->tasks.steal(task)) return task;
+    }
+    return NULL;
+}
+
+template <typename Problem, typename Observer>
+void ParallelBacktracker<Problem, Observer>::runTask(Worker& worker, const Task& task) {
+    worker.prefix = task.path;
+    worker.levels.clear();
+    worker.boundVersion = ~uint64_t(0);
+    if (!isPastBound(worker) && replay(worker, task.path)) search(worker);
+    worker.problem->undo(worker.trail, 0);
+}
+
+/**
+ * Method: replay
+ * --------------
+ * Rebuilds the node the path leads to in the thread's problem, which must
+ * be at the root, returning false if propagation fails on the way.
+ */
+template <typename Problem, typename Observer>
+bool ParallelBacktracker<Problem, Observer>::replay(Worker& worker, const std::vector<Step>& path) {
+    for (const Step& step: path) {
+        if (!worker.problem->propagate(worker.trail)) return false;
+        worker.problem->apply(step.variable, step.value, worker.trail);
+    }
+    return true;
+}
+
+/**
+ * Method: search
+ * --------------
+ * Searches below the thread's current node just as Backtracker::search
+ * does, except that each node's variable and values are kept where the
+ * thread can find them, so that the path to the node can be worked out and
+ * untried values handed over to idle threads.  Returns true once the task
+ * should be given up.
+ */
+template <typename Problem, typename Observer>
+bool ParallelBacktracker<Problem, Observer>::search(Worker& worker) {
+    if (stop.load(std::memory_order_relaxed) || (isDeterministic && isPastBound(worker))) return true;
+
+    Problem& problem = *worker.problem;
+    size_t entered = worker.trail.size();
+    worker.observer.enterNode();
+    if (!problem.propagate(worker.trail)) {
+        problem.undo(worker.trail, entered);
+        return false;
+    }
+
+    size_t propagated = worker.trail.size();
+    Variable variable;
+    if (!problem.chooseVariable(variable)) {
+        worker.observer.recordSolution();
+        bool isStopping = recordSolution(worker);
+        problem.undo(worker.trail, entered);
+        return isStopping;
+    }
+
+    Level level;
+    level.variable = variable;
+    level.values = problem.getValues(variable);
+    level.numTaken = 0;
+    worker.levels.push_back(&level);
+    while (problem.nextValue(level.values, level.value)) {
+        level.index = level.numTaken++;
+        if (numIdle.load(std::memory_order_relaxed) > 0 && worker.tasks.isEmpty()) donate(worker);
+        problem.apply(variable, level.value, worker.trail);
+        worker.numNodes++;
+        worker.observer.applyValue(variable, level.value);
+        bool isStopping = search(worker);
+        worker.observer.retractValue(variable, level.value);
+        problem.undo(worker.trail, propagated);
+        if (isStopping) {
+            worker.levels.pop_back();
+            problem.undo(worker.trail, entered);
+            return true;
+        }
+    }
+
+    worker.levels.pop_back();
+    problem.undo(worker.trail, entered);
+    return false;
+}
+
+/**
+ * Method: recordSolution
+ * ----------------------
+ * Records the solution the thread has reached, returning true if its task
+ * should be given up.
+ */
+template <typename Problem, typename Observer>
+bool ParallelBacktracker<Problem, Observer>::recordSolution(Worker& worker) {
+    if (mode == kCount) {
+        uint64_t numSolutions = ++numFound;
+        if (limit == 0 || numSolutions < limit) return false;
+        stop = true;
+        wakeIdle();
+        return true;
+    }
+
+    std::vector<Step> path = getPath(worker, worker.prefix.size() + worker.levels.size());
+    std::lock_guard<std::mutex> guard(solutionsLock);
+    if (!isDeterministic) {
+        if (stop) return true;
+        if (mode == kFindAll) listener(static_cast<const Problem&>(*worker.problem));
+        else if (mode == kFindFirst) solutions.push_back(path);
+        if (++numFound != limit) return false;
+        stop = true;
+        wakeIdle();
+        return true;
+    }
+
+    if (limit == 0) {
+        numFound++;
+        solutions.push_back(path);
+        return false;
+    }
+
+    if (!bound.empty() && !precedes(path, bound)) return true;
+    numFound++;
+    solutions.push_back(path);
+    std::push_heap(solutions.begin(), solutions.end(), precedes);
+    if (solutions.size() > limit) {
+        std::pop_heap(solutions.begin(), solutions.end(), precedes);
+        solutions.pop_back();
+    }
+    if (solutions.size() == limit) {
+        bound = solutions.front();
+        boundVersion++;
+    }
+    return false;
+}
+
+/**
+ * Method: donate
+ * --------------
+ * Turns the untried values of the thread's shallowest open node that has
+ * any into tasks on its deque, where idle threads can steal them.
+ */
+template <typename Problem, typename Observer>
+void ParallelBacktracker<Problem, Observer>::donate(Worker& worker) {
+    size_t depth = worker.prefix.size();
+    for (Level *open: worker.levels) {
+        Value value;
+        bool isDonated = false;
+        while (worker.problem->nextValue(open->values, value)) {
+            Task *task = new Task();
+            task->path = getPath(worker, depth);
+            Step step = { open->variable, value, open->numTaken++ };
+            task->path.push_back(step);
+            numPending++;
+            worker.tasks.push(task);
+            isDonated = true;
+        }
+        if (isDonated) {
+            wakeIdle();
+            return;
+        }
+        depth++;
+    }
+}
+
+/**
+ * Method: wakeIdle
+ * ----------------
+ * Wakes every idle thread, because there are new tasks to steal or the
+ * search is over.
+ */
+template <typename Problem, typename Observer>
+void ParallelBacktracker<Problem, Observer>::wakeIdle() {
+    {
+        std::lock_guard<std::mutex> guard(idleLock);
+        workVersion++;
+    }
+    idleSignal.notify_all();
+}
+
+/**
+ * Method: isPastBound
+ * -------------------
+ * Returns true if the thread's current node comes after the bound, under
+ * deterministic ordering.
+ */
+template <typename Problem, typename Observer>
+bool ParallelBacktracker<Problem, Observer>::isPastBound(Worker& worker) {
+    if (!isDeterministic) return false;
+    size_t depth = worker.prefix.size() + worker.levels.size();
+    size_t first = depth == 0 ? 0 : depth - 1;
+    if (worker.boundVersion != boundVersion.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> guard(solutionsLock);
+        worker.boundVersion = boundVersion;
+        worker.bound = bound;
+        worker.isOnBound.assign(1, !bound.empty());
+        first = 0;
+    }
+
+    const std::vector<Step>& bound = worker.bound;
+    std::vector<char>& isOnBound = worker.isOnBound;
+    isOnBound.resize(depth + 1);
+    for (size_t d = first; d < depth; d++) {
+        bool isAligned = isOnBound[d] && d < bound.size();
+        if (isAligned && getIndex(worker, d) > bound[d].index) return true;
+        isOnBound[d + 1] = isAligned && getIndex(worker, d) == bound[d].index;
+    }
+    return false;
+}
+
+/**
+ * Methods: getPath, getIndex
+ * --------------------------
+ * Return the first depth steps of the path to the thread's current node,
+ * and the position of the value taken at the provided depth.
+ */
+template <typename Problem, typename Observer>
+std::vector<typename ParallelBacktracker<Problem, Observer>::Step>
+ParallelBacktracker<Problem, Observer>::getPath(const Worker& worker, size_t depth) {
+    std::vector<Step> path(worker.prefix.begin(), worker.prefix.begin() + std::min(depth, worker.prefix.size()));
+    for (size_t i = 0; path.size() < depth; i++) {
+        const Level& level = *worker.levels[i];
+        Step step = { level.variable, level.value, level.index };
+        path.push_back(step);
+    }
+    return path;
+}
+
+template <typename Problem, typename Observer>
+int ParallelBacktracker<Problem, Observer>::getIndex(const Worker& worker, size_t depth) {
+    if (depth < worker.prefix.size()) return worker.prefix[depth].index;
+    return worker.levels[depth - worker.prefix.size()]->index;
+}
+
+template <typename Problem, typename Observer>
+bool ParallelBacktracker<Problem, Observer>::precedes(const std::vector<Step>& one, const std::vector<Step>& two) {
+    for (size_t i = 0; i < one.size() && i < two.size(); i++) {
+        if (one[i].index != two[i].index) return one[i].index < two[i].index;
+    }
+    return one.size() < two.size();
+}
@@ -0,0 +1,265 @@
+/**
+ * File: solution-stream.cpp
+ * -------------------------
+ * Presents the implementation of the SolutionStreamWriter and
+ * SolutionStreamReader classes.  Values are packed least significant bit
+ * first: value v of record r in a chunk occupies the bitsPerValue bits
+ * starting at bit (r * valuesPerRecord + v) * bitsPerValue of that chunk,
+ * where bit b is bit b % 8 of byte b / 8.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "solution-stream.h"
+using namespace std;
+
+/* Constants */
+static const char kHeaderMagic[] = "FBSS";
+static const char kTrailerMagic[] = "FBSI";
+static const uint16_t kVersion = 1;
+static const size_t kHeaderSize = 32;
+static const size_t kIndexEntrySize = 16;
+static const size_t kTrailerSize = 24;
+static const size_t kMaxPendingChunks = 64; // memory the writer may use before write has to wait
+
+int bitsNeededFor(uint32_t maxValue) {
+    int bits = 1;
+    while (bits < 32 && (maxValue >> bits) != 0) bits++;
+    return bits;
+}
+
+/**
+ * Functions: storeLittleEndian, loadLittleEndian
+ * ----------------------------------------------
+ * Store and load unsigned integers of the specified number of bytes,
+ * least significant byte first.
+ */
+static void storeLittleEndian(uint8_t *bytes, uint64_t value, int numBytes) {
+    for (int i = 0; i < numBytes; i++) {
+        bytes[i] = uint8_t(value >> (8 * i));
+    }
+}
+
+static uint64_t loadLittleEndian(const uint8_t *bytes, int numBytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < numBytes; i++) {
+        value |= uint64_t(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+SolutionStreamWriter::SolutionStreamWriter(const string& filename, SolutionKind kind, int valuesPerRecord,
+                                           int bitsPerValue, int recordsPerChunk) :
+    file(fopen(filename.c_str(), "wb")),
+    valuesPerRecord(valuesPerRecord),
+    bitsPerValue(bitsPerValue),
+    recordsPerChunk(recordsPerChunk),
+    chunkBytes((uint64_t(recordsPerChunk) * valuesPerRecord * bitsPerValue + 7) / 8),
+    numRecords(0),
+    chunk(chunkBytes, 0),
+    numRecordsInChunk(0),
+    bitPosition(0),
+    nextOffset(kHeaderSize),
+    closing(false),
+    failed(false) {
+    if (file == NULL) return;
+    uint8_t header[kHeaderSize] = {0};
+    memcpy(header, kHeaderMagic, 4);
+    storeLittleEndian(header + 4, kVersion, 2);
+    storeLittleEndian(header + 6, kind, 2);
+    storeLittleEndian(header + 8, bitsPerValue, 2);
+    storeLittleEndian(header + 12, valuesPerRecord, 4);
+    storeLittleEndian(header + 16, recordsPerChunk, 4);
+    if (fwrite(header, 1, kHeaderSize, file) != kHeaderSize) failed = true;
+    background = thread(&SolutionStreamWriter::writePendingChunks, this);
+}
+
+SolutionStreamWriter::~SolutionStreamWriter() {
+    close();
+}
+
+void SolutionStreamWriter::write(const int *values) {
+    if (file == NULL) return;
+    for (int v = 0; v < valuesPerRecord; v++) {
+        uint64_t value = uint32_t(values[v]);
+        for (int bit = 0; bit < bitsPerValue; ) {
+            uint64_t byte = bitPosition / 8;
+            int offset = bitPosition % 8;
+            int numBits = min(8 - offset, bitsPerValue - bit);
+            chunk[byte] |= uint8_t(((value >> bit) & ((1u << numBits) - 1)) << offset);
+            bit += numBits;
+            bitPosition += numBits;
+        }
+    }
+    numRecords++;
+    if (++numRecordsInChunk == (uint32_t) recordsPerChunk) flushChunk();
+}
+
+/**
+ * Method: flushChunk
+ * ------------------
+ * Hands the chunk being filled to the background thread, and starts a new
+ * one in a spare buffer.  Waits only if too many chunks are already pending.
+ */
+void SolutionStreamWriter::flushChunk() {
+    if (file == NULL || numRecordsInChunk == 0) return;
+    size_t numBytes = (bitPosition + 7) / 8;
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this]() { return pending.size() < kMaxPendingChunks; });
+    pending.push_back(PendingChunk());
+    pending.back().bytes.swap(chunk);
+    pending.back().bytes.resize(numBytes);
+    pending.back().numRecords = numRecordsInChunk;
+    if (!spares.empty()) {
+        chunk.swap(spares.back());
+        spares.pop_back();
+    }
+    guard.unlock();
+    changed.notify_all();
+
+    chunk.assign(chunkBytes, 0);
+    numRecordsInChunk = 0;
+    bitPosition = 0;
+}
+
+/**
+ * Method: writePendingChunks
+ * --------------------------
+ * Runs on the background thread, writing chunks to the file in the order
+ * they were flushed and recording each in the index, until close is called
+ * and nothing is left pending.
+ */
+void SolutionStreamWriter::writePendingChunks() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        changed.wait(guard, [this]() { return closing || !pending.empty(); });
+        if (pending.empty()) return;
+
+        PendingChunk next;
+        next.bytes.swap(pending.front().bytes);
+        next.numRecords = pending.front().numRecords;
+        pending.pop_front();
+        guard.unlock();
+        changed.notify_all();
+
+        bool written = fwrite(next.bytes.data(), 1, next.bytes.size(), file) == next.bytes.size();
+        ChunkEntry entry = { nextOffset, next.numRecords, (uint32_t) next.bytes.size() };
+        nextOffset += next.bytes.size();
+
+        guard.lock();
+        if (!written) failed = true;
+        index.push_back(entry);
+        spares.push_back(vector<uint8_t>());
+        spares.back().swap(next.bytes);
+    }
+}
+
+bool SolutionStreamWriter::close() {
+    if (file == NULL) return false;
+    flushChunk();
+    {
+        lock_guard<mutex> guard(lock);
+        closing = true;
+    }
+    changed.notify_all();
+    background.join();
+
+    vector<uint8_t> tail(index.size() * kIndexEntrySize + kTrailerSize);
+    for (size_t i = 0; i < index.size(); i++) {
+        uint8_t *entry = &tail[i * kIndexEntrySize];
+        storeLittleEndian(entry, index[i].offset, 8);
+        storeLittleEndian(entry + 8, index[i].numRecords, 4);
+        storeLittleEndian(entry + 12, index[i].numBytes, 4);
+    }
+    uint8_t *trailer = &tail[index.size() * kIndexEntrySize];
+    storeLittleEndian(trailer, nextOffset, 8);
+    storeLittleEndian(trailer + 8, numRecords, 8);
+    storeLittleEndian(trailer + 16, index.size(), 4);
+    memcpy(trailer + 20, kTrailerMagic, 4);
+    if (fwrite(tail.data(), 1, tail.size(), file) != tail.size()) failed = true;
+    if (fclose(file) != 0) failed = true;
+    file = NULL;
+    return !failed;
+}
+
+SolutionStreamReader::SolutionStreamReader(const string& filename) :
+    file(filename),
+    data(file.getData()),
+    size(file.getSize()),
+    kind(kQueensSolutions),
+    valuesPerRecord(0),
+    bitsPerValue(0),
+    recordsPerChunk(0),
+    numRecords(0),
+    index(NULL),
+    numChunks(0) {
+    if (data != NULL && !parse()) {
+        file.close();
+        data = NULL;
+        size = 0;
+    }
+}
+
+/**
+ * Method: parse
+ * -------------
+ * Reads and validates the header, the trailer, and every entry in the
+ * index, returning false if the file isn't a well-formed solution stream.
+ * Each chunk has to lie between the header and the index, and be long
+ * enough to hold the records the index says it does.
+ */
+bool SolutionStreamReader::parse() {
+    if (size < kHeaderSize + kTrailerSize) return false;
+    if (memcmp(data, kHeaderMagic, 4) != 0 || loadLittleEndian(data + 4, 2) != kVersion) return false;
+    const uint8_t *trailer = data + size - kTrailerSize;
+    if (memcmp(trailer + 20, kTrailerMagic, 4) != 0) return false;
+
+    kind = SolutionKind(loadLittleEndian(data + 6, 2));
+    bitsPerValue = loadLittleEndian(data + 8, 2);
+    valuesPerRecord = loadLittleEndian(data + 12, 4);
+    recordsPerChunk = loadLittleEndian(data + 16, 4);
+    uint64_t indexOffset = loadLittleEndian(trailer, 8);
+    numRecords = loadLittleEndian(trailer + 8, 8);
+    numChunks = loadLittleEndian(trailer + 16, 4);
+    if (bitsPerValue < 1 || bitsPerValue > 32 || valuesPerRecord <= 0 || recordsPerChunk <= 0) return false;
+    if (indexOffset < kHeaderSize || indexOffset > size) return false;
+    if (indexOffset + uint64_t(numChunks) * kIndexEntrySize + kTrailerSize != size) return false;
+    if (numRecords > uint64_t(numChunks) * recordsPerChunk) return false;
+    index = data + indexOffset;
+
+    uint64_t bitsPerRecord = uint64_t(valuesPerRecord) * bitsPerValue;
+    for (uint32_t i = 0; i < numChunks; i++) {
+        const uint8_t *entry = index + uint64_t(i) * kIndexEntrySize;
+        uint64_t offset = loadLittleEndian(entry, 8);
+        uint64_t chunkRecords = loadLittleEndian(entry + 8, 4);
+        uint64_t chunkBytes = loadLittleEndian(entry + 12, 4);
+        if (offset < kHeaderSize || offset > indexOffset || chunkBytes > indexOffset - offset) return false;
+        if (chunkRecords > uint64_t(recordsPerChunk) || chunkRecords > chunkBytes * 8 / bitsPerRecord) return false;
+    }
+    return true;
+}
+
+bool SolutionStreamReader::read(uint64_t record, int *values) const {
+    if (record >= numRecords) return false;
+    const uint8_t *entry = index + (record / recordsPerChunk) * kIndexEntrySize;
+    if (record % recordsPerChunk >= loadLittleEndian(entry + 8, 4)) return false;
+    const uint8_t *chunk = data + loadLittleEndian(entry, 8);
+    uint64_t bitPosition = (record % recordsPerChunk) * valuesPerRecord * bitsPerValue;
+    for (int v = 0; v < valuesPerRecord; v++) {
+        uint32_t value = 0;
+        for (int bit = 0; bit < bitsPerValue; ) {
+            int offset = bitPosition % 8;
+            int numBits = min(8 - offset, bitsPerValue - bit);
+            value |= uint32_t((chunk[bitPosition / 8] >> offset) & ((1u << numBits) - 1)) << bit;
+            bit += numBits;
+            bitPosition += numBits;
+        }
+        values[v] = value;
+    }
+    return true;
+}
+
+bool SolutionStreamReader::read(uint64_t record, vector<int>& values) const {
+    values.resize(valuesPerRecord);
+    return read(record, values.data());
+}
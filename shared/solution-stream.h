@@ -0,0 +1,211 @@
+/**
+ * File: solution-stream.h
+ * -----------------------
+ * Defines the classes that write and read solution streams, which are
+ * compact binary files holding many solutions to the same puzzle.  Every
+ * solution (or record) is a fixed number of small integers, each packed
+ * into the fewest bits that can hold it: one row index per column for the
+ * N-Queens problem, and one 4-bit digit per cell for SuDoKu.
+ *
+ * A stream is laid out as follows, with every integer stored little-endian:
+ *
+ *     header   32 bytes: "FBSS", version, kind, bits per value,
+ *              values per record, and records per chunk
+ *     chunks   the records themselves, packed back to back, recordsPerChunk
+ *              to a chunk, with each chunk starting on a byte boundary
+ *     index    one 16-byte entry per chunk: its offset, record count, and size
+ *     trailer  24 bytes: the index offset, the record count, the chunk count,
+ *              and "FBSI"
+ *
+ * The index allows any record to be located without reading those before it.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mapped-file.h"
+
+/**
+ * Type: SolutionKind
+ * ------------------
+ * Identifies the puzzle whose solutions a stream holds.
+ */
+enum SolutionKind {
+    kQueensSolutions = 1,
+    kSuDoKuSolutions = 2
+};
+
+/**
+ * Function: bitsNeededFor
+ * -----------------------
+ * Returns the number of bits needed to store every integer between 0 and
+ * maxValue, inclusive (always at least 1).
+ */
+int bitsNeededFor(uint32_t maxValue);
+
+/**
+ * Class: SolutionStreamWriter
+ * ---------------------------
+ * Appends records to a new solution stream.  Records are packed into a chunk
+ * in memory, and full chunks are handed to a background thread that does the
+ * actual writing, so the thread calling write never waits on the disk unless
+ * the writer falls kMaxPendingChunks chunks behind.
+ */
+class SolutionStreamWriter {
+public:
+
+    /**
+     * Constructor: SolutionStreamWriter
+     * ---------------------------------
+     * Creates (or truncates) the named file and writes its header.  Every
+     * record will consist of valuesPerRecord integers of bitsPerValue bits.
+     * Use isOpen to confirm that the file could be created.
+     */
+    SolutionStreamWriter(const std::string& filename, SolutionKind kind, int valuesPerRecord,
+                         int bitsPerValue, int recordsPerChunk = 4096);
+
+    /**
+     * Destructor: ~SolutionStreamWriter
+     * ---------------------------------
+     * Closes the stream, if close hasn't already been called.
+     */
+    ~SolutionStreamWriter();
+
+    /**
+     * Method: isOpen
+     * --------------
+     * Returns true if and only if the stream can (still) be written to.
+     * Records written to a stream that isn't open are ignored.
+     */
+    bool isOpen() const { return file != NULL; }
+
+    /**
+     * Method: write
+     * -------------
+     * Appends one record, made up of the first valuesPerRecord integers
+     * in values.
+     */
+    void write(const int *values);
+    void write(const std::vector<int>& values) { write(values.data()); }
+
+    /**
+     * Method: close
+     * -------------
+     * Writes any records still in memory along with the index and trailer,
+     * and closes the file.  Returns true if and only if everything was
+     * written successfully.
+     */
+    bool close();
+
+    /**
+     * Method: getRecordCount
+     * ----------------------
+     * Returns the number of records written so far.
+     */
+    uint64_t getRecordCount() const { return numRecords; }
+
+private:
+    /* Information about each chunk, as it will appear in the index. */
+    struct ChunkEntry {
+        uint64_t offset;
+        uint32_t numRecords;
+        uint32_t numBytes;
+    };
+
+    /* A chunk handed off to the background thread. */
+    struct PendingChunk {
+        std::vector<uint8_t> bytes;
+        uint32_t numRecords;
+    };
+
+    FILE *file;
+    int valuesPerRecord;
+    int bitsPerValue;
+    int recordsPerChunk;
+    size_t chunkBytes;
+    uint64_t numRecords;
+
+    std::vector<uint8_t> chunk;    // the chunk currently being filled
+    uint32_t numRecordsInChunk;
+    uint64_t bitPosition;          // where the next value goes within chunk
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<PendingChunk> pending;         // chunks waiting to be written
+    std::vector<std::vector<uint8_t> > spares; // written chunks, ready for reuse
+    std::vector<ChunkEntry> index;
+    uint64_t nextOffset;
+    bool closing;
+    bool failed;
+    std::thread background;
+
+    void flushChunk();
+    void writePendingChunks();
+    SolutionStreamWriter(const SolutionStreamWriter&);            // not copyable
+    SolutionStreamWriter& operator=(const SolutionStreamWriter&);
+};
+
+/**
+ * Class: SolutionStreamReader
+ * ---------------------------
+ * Provides random access to the records of an existing solution stream.
+ * The file is memory-mapped where the platform allows it (and read into
+ * memory otherwise), and records are decoded straight from the mapping,
+ * without copying the file.
+ */
+class SolutionStreamReader {
+public:
+
+    /**
+     * Constructor: SolutionStreamReader
+     * ---------------------------------
+     * Opens the named stream.  Use isOpen to confirm that the file exists and
+     * is a well-formed solution stream.
+     */
+    SolutionStreamReader(const std::string& filename);
+
+    /**
+     * Methods: isOpen, getKind, getValuesPerRecord, getBitsPerValue, getRecordCount
+     * -----------------------------------------------------------------------------
+     * Report whether the stream was opened successfully and, if so, what
+     * its header and trailer say about it.
+     */
+    bool isOpen() const { return data != NULL; }
+    SolutionKind getKind() const { return kind; }
+    int getValuesPerRecord() const { return valuesPerRecord; }
+    int getBitsPerValue() const { return bitsPerValue; }
+    uint64_t getRecordCount() const { return numRecords; }
+
+    /**
+     * Method: read
+     * ------------
+     * Decodes the record at the specified index (counting from 0) into values,
+     * which must have room for getValuesPerRecord() integers.  Returns false,
+     * leaving values as they were, if the stream has no such record.
+     */
+    bool read(uint64_t record, int *values) const;
+    bool read(uint64_t record, std::vector<int>& values) const;
+
+private:
+    MappedFile file;
+    const uint8_t *data;                 // the contents of the file, or NULL if it isn't a stream
+    size_t size;
+    SolutionKind kind;
+    int valuesPerRecord;
+    int bitsPerValue;
+    uint32_t recordsPerChunk;
+    uint64_t numRecords;
+    const uint8_t *index;
+    uint32_t numChunks;
+
+    bool parse();
+    SolutionStreamReader(const SolutionStreamReader&);            // not copyable
+    SolutionStreamReader& operator=(const SolutionStreamReader&);
+};
@@ -0,0 +1,48 @@
+/**
+ * File: stopwatch.h
+ * -----------------
+ * Defines a Stopwatch class for timing code far more precisely than the
+ * Timer class of the Stanford library, which only reports whole milliseconds
+ * and so can't time anything that finishes in less than a few of them.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Class: Stopwatch
+ * ----------------
+ * Measures elapsed wall time using the monotonic steady clock, whose
+ * resolution is typically a nanosecond or so.  The stopwatch starts
+ * running as soon as it's constructed.
+ */
+class Stopwatch {
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * Method: restart
+     * ---------------
+     * Resets the elapsed time to zero.
+     */
+    void restart() { start = std::chrono::steady_clock::now(); }
+
+    /**
+     * Methods: getElapsedSeconds, getElapsedNanoseconds
+     * -------------------------------------------------
+     * Return the time elapsed since the stopwatch was constructed or
+     * last restarted.
+     */
+    double getElapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    uint64_t getElapsedNanoseconds() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,153 @@
+/**
+ * File: work-stealing-deque.h
+ * ---------------------------
+ * Defines the WorkStealingDeque class template, the lock-free deque of
+ * Chase and Lev that lets one thread push and pop work at one end while
+ * any number of others steal from the other end.  The atomics follow the
+ * C11 formulation of Lê, Pop, Cohen, and Zappa Nardelli.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Class: WorkStealingDeque
+ * ------------------------
+ * Holds items of type T, which should be something as cheap to copy as a
+ * pointer, in a circular array that doubles whenever it fills up.  Only
+ * the thread that owns the deque may push or take, both at the bottom, so
+ * the owner works through its items newest first; other threads steal the
+ * oldest.  Arrays outgrown while thieves might still be reading them are
+ * kept until the deque is destroyed.
+ */
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 64);
+    ~WorkStealingDeque();
+
+    /**
+     * Method: push
+     * ------------
+     * Adds the item at the bottom.  Only the owner may call this.
+     */
+    void push(T item);
+
+    /**
+     * Method: take
+     * ------------
+     * Removes the item at the bottom, returning false if there wasn't one
+     * or a thief got to it first.  Only the owner may call this.
+     */
+    bool take(T& item);
+
+    /**
+     * Method: steal
+     * -------------
+     * Removes the item at the top, returning false if there wasn't one or
+     * another thread got to it first.  Any thread may call this.
+     */
+    bool steal(T& item);
+
+    /**
+     * Method: isEmpty
+     * ---------------
+     * Returns true if the deque looked empty, which is only a hint, since
+     * thieves can take items at any time.
+     */
+    bool isEmpty() const { return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed); }
+
+private:
+    struct Buffer {
+        int64_t capacity;
+        std::atomic<T> *items;
+
+        explicit Buffer(int64_t capacity) : capacity(capacity), items(new std::atomic<T>[capacity]) {}
+        ~Buffer() { delete[] items; }
+        T get(int64_t index) const { return items[index & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { items[index & (capacity - 1)].store(item, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    std::atomic<Buffer *> buffer;
+    std::vector<Buffer *> retired;
+
+    WorkStealingDeque(const WorkStealingDeque&);
+    WorkStealingDeque& operator=(const WorkStealingDeque&);
+};
+
+/*
+ * Implementation notes: WorkStealingDeque templates
+ * -------------------------------------------------
+ * top and bottom only ever grow, and index the circular array modulo its
+ * capacity, which is always a power of 2.  The owner races thieves only
+ * for the last item, which take settles with the same compare-and-swap
+ * on top that thieves use, and the sequentially consistent fences keep
+ * the owner's lowered bottom and a thief's read of top from passing one
+ * another.
+ */
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capacity) : top(0), bottom(0) {
+    int64_t size = 1;
+    while (size < (int64_t) capacity) size *= 2;
+    buffer.store(new Buffer(size), std::memory_order_relaxed);
+}
+
+template <typename T>
+WorkStealingDeque<T>::~WorkStealingDeque() {
+    delete buffer.load(std::memory_order_relaxed);
+    for (Buffer *old: retired) delete old;
+}
+
+template <typename T>
+void WorkStealingDeque<T>::push(T item) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Buffer *a = buffer.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+        Buffer *grown = new Buffer(2 * a->capacity);
+        for (int64_t i = t; i < b; i++) grown->put(i, a->get(i));
+        retired.push_back(a);
+        buffer.store(grown, std::memory_order_release);
+        a = grown;
+    }
+    a->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::take(T& item) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer *a = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    item = a->get(b);
+    if (t < b) return true;
+    bool isTaken = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return isTaken;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::steal(T& item) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return false;
+    Buffer *a = buffer.load(std::memory_order_acquire);
+    item = a->get(t);
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
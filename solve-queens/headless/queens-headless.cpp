@@ -0,0 +1,356 @@
+/**
+ * File: queens-headless.cpp
+ * -------------------------
+ * Presents a command-line program that solves the N-Queens problem without
+ * any animation.  Usage:
+ *
+ *     queens-headless [-count | -list | -construct | -minconflicts]
+ *                     [-stats] [-threads n] [-deterministic] [-batch engine]
+ *                     [-out stream] dimension ...
+ *     queens-headless -read stream
+ *     queens-headless -complete placement
+ *
+ * By default, one solution is printed for each dimension, as the row of the
+ * queen in each column.  -count counts every solution instead, and -list
+ * streams every solution, one per line, as it's found.  -stats runs a
+ * single-threaded search that reports how much work it did, and -threads
+ * limits the number of threads used (by default, one per hardware thread).
+ * -deterministic has the threads agree on the solution the single-threaded
+ * search would print, rather than printing whichever one they find first.
+ * -batch makes -count use a single-threaded QueensBatchCounter instead, with
+ * the named engine (best, scalar, or avx2), which reports only the total.
+ * With -out, -list writes the solutions to a compact solution stream (see
+ * solution-stream.h) instead of printing them, and -read prints the
+ * solutions in such a stream.  -complete reads a partial placement from a
+ * file (see readPartialPlacement in queens-completion.h) and extends it to a
+ * full solution, or reports that it can't be extended, for any dimension.
+ * Backtracking is limited to boards of dimension kMaxBitboardDimension, but
+ * -construct and -minconflicts handle boards with millions of rows, the
+ * first by building a solution from a formula and the second by local search.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "queens-batch.h"
+#include "queens-bitboard.h"
+#include "queens-completion.h"
+#include "queens-constants.h"
+#include "queens-enumerator.h"
+#include "queens-large.h"
+#include "queens-observers.h"
+#include "queens-parallel.h"
+#include "solution-stream.h"
+#include "stopwatch.h"
+using namespace std;
+
+/**
+ * Function: printUsage
+ * --------------------
+ * Explains how the program is meant to be invoked.
+ */
+static void printUsage(const string& program) {
+    cerr << "Usage: " << program << " [-count | -list | -construct | -minconflicts]"
+         << " [-stats] [-threads n] [-deterministic] [-batch best | scalar | avx2] [-out stream] dimension ..."
+         << endl;
+    cerr << "       " << program << " -read stream" << endl;
+    cerr << "       " << program << " -complete placement" << endl;
+}
+
+/**
+ * Function: printRows
+ * -------------------
+ * Prints the rows of the queens in a solution on one line.
+ */
+template <typename Solver>
+static void printRows(const Solver& solver, int dimension) {
+    for (int col = 0; col < dimension; col++) {
+        cout << (col > 0 ? " " : "") << solver.getRow(col);
+    }
+    cout << endl;
+}
+
+/**
+ * Function: placeManyQueens
+ * -------------------------
+ * Places queens on a board of any size, either by construction or by
+ * min-conflicts local search, printing the solution and confirming that
+ * it really is one.
+ */
+static void placeManyQueens(int dimension, bool construct) {
+    Stopwatch stopwatch;
+    vector<int> solution;
+    uint64_t numSwaps = 0;
+    if (construct) {
+        solution = constructQueens(dimension);
+    } else {
+        QueensMinConflicts solver(dimension);
+        if (solver.solve()) solution = solver.getRows();
+        numSwaps = solver.getSwapCount();
+    }
+    double seconds = stopwatch.getElapsedSeconds();
+
+    if (solution.empty()) {
+        cout << "no solution" << endl;
+        return;
+    }
+
+    for (int col = 0; col < dimension; col++) {
+        cout << (col > 0 ? " " : "") << solution[col];
+    }
+    cout << endl;
+    cerr << dimension << " queens: ";
+    if (construct) cerr << "constructed";
+    else cerr << "repaired with " << numSwaps << " swaps";
+    cerr << " in " << seconds << " seconds, " << (isQueensSolution(solution) ? "verified" : "NOT A SOLUTION") << endl;
+}
+
+/**
+ * Function: listSolutions
+ * -----------------------
+ * Prints every solution, one per line, as the enumerator produces them,
+ * or writes them to the named solution stream if there is one.  Returns
+ * false if the stream can't be written.
+ */
+static bool listSolutions(int dimension, const string& outFilename) {
+    QueensEnumerator enumerator(dimension);
+    SolutionStreamWriter *out = NULL;
+    if (!outFilename.empty()) {
+        out = new SolutionStreamWriter(outFilename, kQueensSolutions, dimension, bitsNeededFor(dimension - 1));
+        if (!out->isOpen()) {
+            cerr << "Could not create " << outFilename << endl;
+            delete out;
+            return false;
+        }
+    }
+
+    Stopwatch stopwatch;
+    uint64_t numSolutions = 0;
+    while (enumerator.next()) {
+        const vector<int>& solution = enumerator.current();
+        if (out != NULL) {
+            out->write(solution);
+        } else {
+            for (int col = 0; col < dimension; col++) {
+                cout << (col > 0 ? " " : "") << solution[col];
+            }
+            cout << '\n';
+        }
+        numSolutions++;
+    }
+    cout.flush();
+
+    bool succeeded = true;
+    if (out != NULL) {
+        succeeded = out->close();
+        delete out;
+        if (!succeeded) cerr << "Could not write " << outFilename << endl;
+    }
+    cerr << dimension << " queens: " << numSolutions << " solutions, " << enumerator.getNodeCount()
+         << " nodes, " << stopwatch.getElapsedSeconds() << " seconds" << endl;
+    return succeeded;
+}
+
+/**
+ * Function: printStream
+ * ---------------------
+ * Prints every solution in the named solution stream, one per line.
+ * Returns false if the file isn't a stream of N-Queens solutions, or is
+ * missing some of its records.
+ */
+static bool printStream(const string& filename) {
+    SolutionStreamReader in(filename);
+    if (!in.isOpen() || in.getKind() != kQueensSolutions) {
+        cerr << filename << " is not a stream of N-Queens solutions" << endl;
+        return false;
+    }
+
+    vector<int> solution;
+    for (uint64_t record = 0; record < in.getRecordCount(); record++) {
+        if (!in.read(record, solution)) {
+            cerr << filename << " is missing record " << record << endl;
+            return false;
+        }
+        for (size_t col = 0; col < solution.size(); col++) {
+            cout << (col > 0 ? " " : "") << solution[col];
+        }
+        cout << '\n';
+    }
+    cout.flush();
+    return true;
+}
+
+/**
+ * Function: completePlacement
+ * ---------------------------
+ * Reads the partial placement in the named file and prints a solution that
+ * extends it, or "no solution" if there isn't one.  Returns false if the
+ * file doesn't hold a partial placement.
+ */
+static bool completePlacement(const string& filename) {
+    ifstream in(filename.c_str());
+    int dimension;
+    vector<pair<int, int> > queens;
+    if (!in || !readPartialPlacement(in, dimension, queens)) {
+        cerr << filename << " is not a partial placement" << endl;
+        return false;
+    }
+
+    QueensCompletion solver(dimension);
+    for (const pair<int, int>& queen: queens) {
+        if (!solver.placeQueen(queen.first, queen.second)) {
+            cerr << filename << " places two queens in column " << queen.second << endl;
+            return false;
+        }
+    }
+    Stopwatch stopwatch;
+    bool solved = solver.solve();
+    double seconds = stopwatch.getElapsedSeconds();
+    if (solved) printRows(solver, dimension);
+    else cout << "no solution" << endl;
+    cerr << dimension << " queens: " << queens.size() << " given, " << solver.getNodeCount() << " nodes, "
+         << solver.getRestartCount() << " restarts, " << seconds << " seconds" << endl;
+    return true;
+}
+
+/**
+ * Function: solveWithStats
+ * ------------------------
+ * Solves the problem on one thread, reporting every step of the search
+ * to a CountingQueensObserver and printing its tallies.
+ */
+static void solveWithStats(int dimension) {
+    QueensBitboard solver(dimension);
+    CountingQueensObserver observer;
+    Stopwatch stopwatch;
+    bool solved = solver.solve(observer);
+    double seconds = stopwatch.getElapsedSeconds();
+    if (solved) printRows(solver, dimension);
+    else cout << "no solution" << endl;
+    cerr << dimension << " queens: " << observer.numPlaced << " placed, "
+         << observer.numRemoved << " removed, " << seconds << " seconds" << endl;
+}
+
+/**
+ * Function: solveInParallel
+ * -------------------------
+ * Solves the problem (or counts its solutions) using every thread allowed.
+ */
+static void solveInParallel(int dimension, int numThreads, bool isDeterministic, bool countAll) {
+    QueensParallelSolver solver(dimension, numThreads);
+    solver.setDeterministic(isDeterministic);
+    Stopwatch stopwatch;
+    if (countAll) {
+        solver.count();
+        cout << dimension << " " << solver.getTotalCount() << " " << solver.getUniqueCount() << endl;
+    } else if (solver.solve()) {
+        printRows(solver, dimension);
+    } else {
+        cout << "no solution" << endl;
+    }
+    cerr << dimension << " queens: " << solver.getNodeCount() << " nodes, "
+         << stopwatch.getElapsedSeconds() << " seconds, " << solver.getNumThreads() << " threads" << endl;
+}
+
+/**
+ * Function: countInBatches
+ * ------------------------
+ * Counts the solutions using a QueensBatchCounter with the provided engine.
+ */
+static void countInBatches(int dimension, QueensBatchEngine engine) {
+    QueensBatchCounter counter(dimension, engine);
+    Stopwatch stopwatch;
+    counter.count();
+    cout << dimension << " " << counter.getTotalCount() << endl;
+    cerr << dimension << " queens: " << counter.getNodeCount() << " nodes, " << stopwatch.getElapsedSeconds()
+         << " seconds, " << QueensBatchCounter::getEngineName(counter.getEngine()) << " engine" << endl;
+}
+
+/**
+ * Function: parseEngine
+ * ---------------------
+ * Translates the name of a QueensBatchCounter engine, returning false if
+ * it isn't one.
+ */
+static bool parseEngine(const string& name, QueensBatchEngine& engine) {
+    QueensBatchEngine engines[] = { kBestEngine, kScalarEngine, kAVX2Engine };
+    for (QueensBatchEngine candidate: engines) {
+        if (name == QueensBatchCounter::getEngineName(candidate)) {
+            engine = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function: main
+ * --------------
+ * Defines the entry point of the program, which processes the flags
+ * and then each of the dimensions listed on the command line.
+ */
+int main(int argc, char *argv[]) {
+    bool countAll = false, listAll = false, construct = false, minConflicts = false, withStats = false;
+    int numThreads = 0;
+    bool isDeterministic = false, inBatches = false;
+    QueensBatchEngine engine = kBestEngine;
+    string outFilename;
+    int numDimensions = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-count") {
+            countAll = true;
+        } else if (arg == "-list") {
+            listAll = true;
+        } else if (arg == "-construct") {
+            construct = true;
+        } else if (arg == "-minconflicts") {
+            minConflicts = true;
+        } else if (arg == "-stats") {
+            withStats = true;
+        } else if (arg == "-threads" && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+        } else if (arg == "-deterministic") {
+            isDeterministic = true;
+        } else if (arg == "-batch" && i + 1 < argc) {
+            if (!parseEngine(argv[++i], engine)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            inBatches = true;
+        } else if (arg == "-out" && i + 1 < argc) {
+            outFilename = argv[++i];
+        } else if (arg == "-read" && i + 1 < argc) {
+            return printStream(argv[++i]) ? 0 : 1;
+        } else if (arg == "-complete" && i + 1 < argc) {
+            return completePlacement(argv[++i]) ? 0 : 1;
+        } else {
+            int dimension = atoi(arg.c_str());
+            bool anySize = construct || minConflicts;
+            if (dimension < 1 || (!anySize && dimension > kMaxBitboardDimension)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            if (anySize) {
+                placeManyQueens(dimension, construct);
+            } else if (listAll) {
+                if (!listSolutions(dimension, outFilename)) return 1;
+            } else if (countAll && inBatches) {
+                countInBatches(dimension, engine);
+            } else if (withStats && !countAll) {
+                solveWithStats(dimension);
+            } else {
+                solveInParallel(dimension, numThreads, isDeterministic, countAll);
+            }
+            numDimensions++;
+        }
+    }
+
+    if (numDimensions == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
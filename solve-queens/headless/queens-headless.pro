@@ -0,0 +1,59 @@
+# Qt Creator project file for the headless N-Queens solver
+#
+# Builds the N-Queens search as a plain command-line program.  Only the
+# solver sources from ../src and the code shared by both puzzles in
+# ../../shared are compiled, and the Stanford C++ library is left out
+# entirely, so the program never launches the Java back-end and can be
+# run from scripts and batch jobs.
+
+TEMPLATE = app
+TARGET = queens-headless
+CONFIG += console
+CONFIG -= qt
+CONFIG -= app_bundle
+CONFIG += warn_off
+CONFIG += c++11
+
+SOURCES *= $$PWD/queens-headless.cpp
+SOURCES *= $$PWD/../src/queens-batch.cpp
+SOURCES *= $$PWD/../src/queens-bitboard.cpp
+SOURCES *= $$PWD/../src/queens-completion.cpp
+SOURCES *= $$PWD/../src/queens-counter.cpp
+SOURCES *= $$PWD/../src/queens-enumerator.cpp
+SOURCES *= $$PWD/../src/queens-large.cpp
+SOURCES *= $$PWD/../src/queens-parallel.cpp
+SOURCES *= $$PWD/../../shared/mapped-file.cpp
+SOURCES *= $$PWD/../../shared/solution-stream.cpp
+
+HEADERS *= $$PWD/../src/queens-batch.h
+HEADERS *= $$PWD/../src/queens-bitboard.h
+HEADERS *= $$PWD/../src/queens-completion.h
+HEADERS *= $$PWD/../src/queens-constants.h
+HEADERS *= $$PWD/../src/queens-counter.h
+HEADERS *= $$PWD/../src/queens-enumerator.h
+HEADERS *= $$PWD/../src/queens-large.h
+HEADERS *= $$PWD/../src/queens-observers.h
+HEADERS *= $$PWD/../src/queens-parallel.h
+HEADERS *= $$PWD/../../shared/backtracking.h
+HEADERS *= $$PWD/../../shared/mapped-file.h
+HEADERS *= $$PWD/../../shared/parallel-backtracking.h
+HEADERS *= $$PWD/../../shared/solution-stream.h
+HEADERS *= $$PWD/../../shared/stopwatch.h
+HEADERS *= $$PWD/../../shared/work-stealing-deque.h
+
+INCLUDEPATH *= $$PWD/../src/
+INCLUDEPATH *= $$PWD/../../shared/
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Werror=return-type
+QMAKE_CXXFLAGS += -Werror=uninitialized
+QMAKE_CXXFLAGS += -Wno-sign-compare
+
+!win32 {
+    LIBS += -lpthread
+}
+
+CONFIG(release, debug|release) {
+    QMAKE_CXXFLAGS += -O3
+}
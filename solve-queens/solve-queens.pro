@@ -112,6 +112,9 @@ exists($$PWD/src/test/*.cpp) {
 exists($$PWD/$$PROJECT_FILTER*.cpp) {
     SOURCES *= $$PWD/$$PROJECT_FILTER*.cpp
 }
+exists($$PWD/../shared/*.cpp) {
+    SOURCES *= $$PWD/../shared/*.cpp
+}
 
 exists($$PWD/lib/StanfordCPPLib/*.h) {
     HEADERS *= $$PWD/lib/StanfordCPPLib/*.h
@@ -131,6 +134,9 @@ exists($$PWD/src/$$PROJECT_FILTER*.h) {
 exists($$PWD/$$PROJECT_FILTER*.h) {
     HEADERS *= $$PWD/$$PROJECT_FILTER*.h
 }
+exists($$PWD/../shared/*.h) {
+    HEADERS *= $$PWD/../shared/*.h
+}
 
 INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/
 INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/collections/
@@ -140,6 +146,7 @@ INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/system/
 INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/util/
 INCLUDEPATH *= $$PWD/src/
 INCLUDEPATH *= $$PWD/
+INCLUDEPATH *= $$PWD/../shared/
 exists($$PWD/src/autograder/*.h) {
     INCLUDEPATH *= $$PWD/src/autograder/
 }
@@ -240,6 +247,7 @@ unix:!macx {
     #QMAKE_CXXFLAGS += -Wno-dangling-field
     QMAKE_CXXFLAGS += -Wno-unused-const-variable
     LIBS += -ldl
+    LIBS += -lpthread
 }
 
 # set up configuration flags used internally by the Stanford C++ libraries
@@ -0,0 +1,457 @@
+/**
+ * File: queens-batch.cpp
+ * ----------------------
+ * Presents the implementation of the QueensBatchCounter class.  Every lane
+ * keeps the masks of the column it's currently filling in a frame, along
+ * with a stack of the frames of the columns to its left.  On every step, a
+ * lane either places a queen in the next candidate row (pushing its frame
+ * and moving right), counts the solutions below that queen directly if the
+ * column to its right is the last one, or backtracks (popping the frame to
+ * its left) when no candidates remain.  The scalar engine takes those steps
+ * for one lane at a time, running each subproblem to completion before
+ * starting the next, and the AVX2 engine takes them for eight lanes at once,
+ * handing out subproblems as lanes finish and using the scalar engine's
+ * search to finish the last few subproblems.
+ */
+
+#include <algorithm>
+#include "queens-batch.h"
+#include "queens-constants.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define QUEENS_HAVE_AVX2_ENGINE
+#endif
+using namespace std;
+
+/* Constants */
+static const int kLanesPerRegister = 4;         // 64-bit lanes in an AVX2 register
+static const int kLanes = 2 * kLanesPerRegister; // subproblems in flight at once
+static const int kMinSplitColumn = 1;
+static const int kSplitColumnDivisor = 3;       // subproblems start a third of the way across the board
+
+/**
+ * Type: Frame
+ * -----------
+ * Holds the masks describing one column of one lane's search: the rows and
+ * diagonals attacked by the queens to its left, and the candidate rows not
+ * yet tried.  The four fields fill exactly one AVX2 register.
+ */
+struct Frame {
+    uint64_t rows;
+    uint64_t ascending;
+    uint64_t descending;
+    uint64_t candidates;
+};
+
+/**
+ * Type: LaneSet
+ * -------------
+ * Holds the state of every lane, one array element per lane, so that
+ * the AVX2 engine can load each field into a register in one go.
+ */
+struct LaneSet {
+    alignas(32) uint64_t rows[kLanes];
+    alignas(32) uint64_t ascending[kLanes];
+    alignas(32) uint64_t descending[kLanes];
+    alignas(32) uint64_t candidates[kLanes];
+    alignas(32) int64_t col[kLanes];
+    alignas(32) uint64_t count[kLanes];          // solutions found in the lane's current subproblem
+    uint64_t weight[kLanes];
+    alignas(32) Frame stacks[kLanes][kMaxBitboardDimension + 1];
+};
+
+/**
+ * Type: Batch
+ * -----------
+ * Holds what every engine needs to know about the search as a whole.
+ */
+struct Batch {
+    const vector<QueensBatchCounter::Subproblem> *subproblems;
+    size_t next;                                // index of the next subproblem to hand out
+    int64_t splitColumn;                        // the column every subproblem starts in
+    int64_t leafColumn;                         // the column next to the last one
+    uint64_t allRows;
+    uint64_t numTotal;
+    uint64_t numNodes;
+};
+
+/**
+ * Function: assignSubproblem
+ * --------------------------
+ * Hands the next subproblem to the specified lane, returning false if
+ * there are none left.
+ */
+static bool assignSubproblem(Batch& batch, LaneSet& lanes, int lane) {
+    if (batch.next == batch.subproblems->size()) return false;
+    const QueensBatchCounter::Subproblem& subproblem = (*batch.subproblems)[batch.next++];
+    lanes.rows[lane] = subproblem.rows;
+    lanes.ascending[lane] = subproblem.ascending;
+    lanes.descending[lane] = subproblem.descending;
+    lanes.candidates[lane] = batch.allRows & ~(subproblem.rows | subproblem.ascending | subproblem.descending);
+    lanes.col[lane] = batch.splitColumn;
+    lanes.count[lane] = 0;
+    lanes.weight[lane] = subproblem.weight;
+    return true;
+}
+
+/**
+ * Function: finishLane
+ * --------------------
+ * Adds the solutions found by the specified lane, which has just exhausted
+ * its subproblem, to the running total.
+ */
+static void finishLane(Batch& batch, LaneSet& lanes, int lane) {
+    batch.numTotal += lanes.count[lane] * lanes.weight[lane];
+}
+
+/**
+ * Function: drainLane
+ * -------------------
+ * Finishes the specified lane's subproblem on its own, using an ordinary
+ * scalar search that picks up exactly where the lane left off.
+ */
+static void drainLane(Batch& batch, LaneSet& lanes, int lane) {
+    Frame *stack = lanes.stacks[lane];
+    Frame current = { lanes.rows[lane], lanes.ascending[lane], lanes.descending[lane], lanes.candidates[lane] };
+    int64_t col = lanes.col[lane];
+    while (true) {
+        if (current.candidates == 0) {
+            if (col == batch.splitColumn) break;
+            current = stack[--col];
+            continue;
+        }
+
+        uint64_t queen = current.candidates & -current.candidates;
+        current.candidates ^= queen;
+        Frame child;
+        child.rows = current.rows | queen;
+        child.ascending = ((current.ascending | queen) << 1) & batch.allRows;
+        child.descending = (current.descending | queen) >> 1;
+        child.candidates = batch.allRows & ~(child.rows | child.ascending | child.descending);
+        batch.numNodes++;
+        if (col == batch.leafColumn) {
+            uint64_t numSolutions = __builtin_popcountll(child.candidates);
+            lanes.count[lane] += numSolutions;
+            batch.numNodes += numSolutions;
+        } else {
+            stack[col++] = current;
+            current = child;
+        }
+    }
+    finishLane(batch, lanes, lane);
+}
+
+/**
+ * Function: runScalarEngine
+ * -------------------------
+ * Searches the subproblems one at a time, using ordinary integer
+ * instructions, for processors without the vector instructions the other
+ * engines need.
+ */
+static void runScalarEngine(Batch& batch, LaneSet& lanes) {
+    while (assignSubproblem(batch, lanes, 0)) {
+        drainLane(batch, lanes, 0);
+    }
+}
+
+#ifdef QUEENS_HAVE_AVX2_ENGINE
+
+/**
+ * Function: popcountLanes
+ * -----------------------
+ * Counts the bits set in each 64-bit lane of the provided vector, by looking
+ * up the count for every nibble in a 16-entry table and summing the bytes.
+ */
+__attribute__((target("avx2")))
+static inline __m256i popcountLanes(__m256i values) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbles = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(values, nibbles));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(values, 4), nibbles));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+/**
+ * Function: transpose
+ * -------------------
+ * Transposes a 4x4 matrix of 64-bit integers held in four registers, which
+ * converts between one register per field (across the lanes) and one
+ * register per lane (holding a whole frame).
+ */
+__attribute__((target("avx2")))
+static inline void transpose(__m256i& first, __m256i& second, __m256i& third, __m256i& fourth) {
+    __m256i low01 = _mm256_unpacklo_epi64(first, second);
+    __m256i high01 = _mm256_unpackhi_epi64(first, second);
+    __m256i low23 = _mm256_unpacklo_epi64(third, fourth);
+    __m256i high23 = _mm256_unpackhi_epi64(third, fourth);
+    first = _mm256_permute2x128_si256(low01, low23, 0x20);
+    second = _mm256_permute2x128_si256(high01, high23, 0x20);
+    third = _mm256_permute2x128_si256(low01, low23, 0x31);
+    fourth = _mm256_permute2x128_si256(high01, high23, 0x31);
+}
+
+/**
+ * Type: LaneGroup
+ * ---------------
+ * Holds the state of the four lanes that share one set of AVX2 registers.
+ */
+struct LaneGroup {
+    __m256i rows;
+    __m256i ascending;
+    __m256i descending;
+    __m256i candidates;
+    __m256i col;
+    __m256i count;
+    __m256i nodes;
+};
+
+/**
+ * Functions: loadGroup, storeGroup
+ * --------------------------------
+ * Move the state of the four lanes starting at the specified one between
+ * the lane set and a group of registers.
+ */
+__attribute__((target("avx2")))
+static inline void loadGroup(const LaneSet& lanes, int first, LaneGroup& group) {
+    group.rows = _mm256_load_si256((const __m256i *) &lanes.rows[first]);
+    group.ascending = _mm256_load_si256((const __m256i *) &lanes.ascending[first]);
+    group.descending = _mm256_load_si256((const __m256i *) &lanes.descending[first]);
+    group.candidates = _mm256_load_si256((const __m256i *) &lanes.candidates[first]);
+    group.col = _mm256_load_si256((const __m256i *) &lanes.col[first]);
+    group.count = _mm256_load_si256((const __m256i *) &lanes.count[first]);
+    group.nodes = _mm256_setzero_si256();
+}
+
+__attribute__((target("avx2")))
+static inline void storeGroup(const LaneGroup& group, LaneSet& lanes, int first, uint64_t& numNodes) {
+    _mm256_store_si256((__m256i *) &lanes.rows[first], group.rows);
+    _mm256_store_si256((__m256i *) &lanes.ascending[first], group.ascending);
+    _mm256_store_si256((__m256i *) &lanes.descending[first], group.descending);
+    _mm256_store_si256((__m256i *) &lanes.candidates[first], group.candidates);
+    _mm256_store_si256((__m256i *) &lanes.col[first], group.col);
+    _mm256_store_si256((__m256i *) &lanes.count[first], group.count);
+    alignas(32) uint64_t laneNodes[kLanesPerRegister];
+    _mm256_store_si256((__m256i *) laneNodes, group.nodes);
+    for (int lane = 0; lane < kLanesPerRegister; lane++) numNodes += laneNodes[lane];
+}
+
+/**
+ * Function: advanceGroup
+ * ----------------------
+ * Steps the four lanes of a group at once.  Both outcomes of a step are
+ * computed for every lane and the right one is selected with a mask, so
+ * nothing branches on the state of an individual lane.  The frames pushed
+ * and popped are moved between the registers and the stacks with a
+ * transpose, since each lane's stack top is at its own depth.  Returns a
+ * mask with one bit set for each lane that exhausted its subproblem.
+ */
+__attribute__((target("avx2")))
+static inline unsigned advanceGroup(LaneGroup& group, Frame (*stacks)[kMaxBitboardDimension + 1],
+                                    __m256i allRows, __m256i leafColumn, __m256i splitColumn) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi64x(1);
+    alignas(32) int64_t depth[kLanesPerRegister];
+    _mm256_store_si256((__m256i *) depth, group.col);
+
+    __m256i queen = _mm256_and_si256(group.candidates, _mm256_sub_epi64(zero, group.candidates));
+    __m256i rest = _mm256_xor_si256(group.candidates, queen);
+    __m256i childRows = _mm256_or_si256(group.rows, queen);
+    __m256i childAscending = _mm256_and_si256(_mm256_slli_epi64(_mm256_or_si256(group.ascending, queen), 1), allRows);
+    __m256i childDescending = _mm256_srli_epi64(_mm256_or_si256(group.descending, queen), 1);
+    __m256i childCandidates = _mm256_andnot_si256(
+        _mm256_or_si256(childRows, _mm256_or_si256(childAscending, childDescending)), allRows);
+
+    // push every lane's frame, whatever it does next
+    __m256i top0 = group.rows, top1 = group.ascending, top2 = group.descending, top3 = rest;
+    transpose(top0, top1, top2, top3);
+    _mm256_store_si256((__m256i *) &stacks[0][depth[0]], top0);
+    _mm256_store_si256((__m256i *) &stacks[1][depth[1]], top1);
+    _mm256_store_si256((__m256i *) &stacks[2][depth[2]], top2);
+    _mm256_store_si256((__m256i *) &stacks[3][depth[3]], top3);
+
+    // fetch the frame to the left of every lane, in case it backtracks
+    __m256i leftRows = _mm256_load_si256((const __m256i *) &stacks[0][depth[0] - 1]);
+    __m256i leftAscending = _mm256_load_si256((const __m256i *) &stacks[1][depth[1] - 1]);
+    __m256i leftDescending = _mm256_load_si256((const __m256i *) &stacks[2][depth[2] - 1]);
+    __m256i leftCandidates = _mm256_load_si256((const __m256i *) &stacks[3][depth[3] - 1]);
+    transpose(leftRows, leftAscending, leftDescending, leftCandidates);
+
+    __m256i backtracked = _mm256_cmpeq_epi64(group.candidates, zero);
+    __m256i leaf = _mm256_andnot_si256(backtracked, _mm256_cmpeq_epi64(group.col, leafColumn));
+    __m256i numSolutions = _mm256_and_si256(popcountLanes(childCandidates), leaf);
+    group.count = _mm256_add_epi64(group.count, numSolutions);
+    group.nodes = _mm256_add_epi64(group.nodes, _mm256_add_epi64(_mm256_andnot_si256(backtracked, ones), numSolutions));
+
+    // leaves stay put with the rest of their candidates, everyone else moves right or left
+    group.rows = _mm256_blendv_epi8(_mm256_blendv_epi8(childRows, group.rows, leaf), leftRows, backtracked);
+    group.ascending = _mm256_blendv_epi8(_mm256_blendv_epi8(childAscending, group.ascending, leaf),
+                                         leftAscending, backtracked);
+    group.descending = _mm256_blendv_epi8(_mm256_blendv_epi8(childDescending, group.descending, leaf),
+                                          leftDescending, backtracked);
+    group.candidates = _mm256_blendv_epi8(_mm256_blendv_epi8(childCandidates, rest, leaf),
+                                          leftCandidates, backtracked);
+    __m256i advanced = _mm256_andnot_si256(_mm256_or_si256(leaf, backtracked), _mm256_cmpeq_epi64(zero, zero));
+    __m256i exhausted = _mm256_and_si256(backtracked, _mm256_cmpeq_epi64(group.col, splitColumn));
+    group.col = _mm256_add_epi64(_mm256_sub_epi64(group.col, advanced), backtracked);
+    return _mm256_movemask_pd(_mm256_castsi256_pd(exhausted));
+}
+
+/**
+ * Function: stepAVX2Lanes
+ * -----------------------
+ * Steps all the lanes using AVX2 instructions, four lanes to a register.
+ * The groups of registers are independent of one another, so the processor
+ * can overlap the steps of one with those of the others.
+ */
+__attribute__((target("avx2")))
+static unsigned stepAVX2Lanes(Batch& batch, LaneSet& lanes) {
+    const __m256i allRows = _mm256_set1_epi64x(batch.allRows);
+    const __m256i leafColumn = _mm256_set1_epi64x(batch.leafColumn);
+    const __m256i splitColumn = _mm256_set1_epi64x(batch.splitColumn);
+
+    LaneGroup low, high;
+    loadGroup(lanes, 0, low);
+    loadGroup(lanes, kLanesPerRegister, high);
+    unsigned finished = 0;
+    while (finished == 0) {
+        finished = advanceGroup(low, lanes.stacks, allRows, leafColumn, splitColumn);
+        finished |= advanceGroup(high, lanes.stacks + kLanesPerRegister, allRows, leafColumn, splitColumn)
+                    << kLanesPerRegister;
+    }
+    storeGroup(low, lanes, 0, batch.numNodes);
+    storeGroup(high, lanes, kLanesPerRegister, batch.numNodes);
+    return finished;
+}
+
+/**
+ * Function: runAVX2Engine
+ * -----------------------
+ * Keeps every lane busy with subproblems until they run out, and then
+ * finishes whatever subproblems the lanes are still working on.
+ */
+static void runAVX2Engine(Batch& batch, LaneSet& lanes) {
+    const unsigned allLanes = (1u << kLanes) - 1;
+    unsigned busy = 0;
+    for (int lane = 0; lane < kLanes; lane++) {
+        if (assignSubproblem(batch, lanes, lane)) busy |= 1u << lane;
+    }
+
+    while (busy == allLanes) {
+        unsigned finished = stepAVX2Lanes(batch, lanes);
+        for (int lane = 0; lane < kLanes; lane++) {
+            if ((finished & (1u << lane)) == 0) continue;
+            finishLane(batch, lanes, lane);
+            if (!assignSubproblem(batch, lanes, lane)) busy &= ~(1u << lane);
+        }
+    }
+
+    for (int lane = 0; lane < kLanes; lane++) {
+        if (busy & (1u << lane)) drainLane(batch, lanes, lane);
+    }
+}
+
+#else
+
+static void runAVX2Engine(Batch& batch, LaneSet& lanes) {
+    runScalarEngine(batch, lanes);
+}
+
+#endif
+
+QueensBatchCounter::QueensBatchCounter(int dimension, QueensBatchEngine engine) :
+    dimension(dimension),
+    engine(engine),
+    allRows(dimension == 64 ? ~uint64_t(0) : (uint64_t(1) << dimension) - 1),
+    splitColumn(0),
+    numTotal(0),
+    numNodes(0) {
+    if (this->engine == kBestEngine) this->engine = isEngineSupported(kAVX2Engine) ? kAVX2Engine : kScalarEngine;
+    if (!isEngineSupported(this->engine)) this->engine = kScalarEngine;
+}
+
+bool QueensBatchCounter::isEngineSupported(QueensBatchEngine engine) {
+    switch (engine) {
+    case kBestEngine:
+    case kScalarEngine:
+        return true;
+    case kAVX2Engine:
+#ifdef QUEENS_HAVE_AVX2_ENGINE
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char *QueensBatchCounter::getEngineName(QueensBatchEngine engine) {
+    switch (engine) {
+    case kBestEngine: return "best";
+    case kScalarEngine: return "scalar";
+    case kAVX2Engine: return "avx2";
+    }
+    return "unknown";
+}
+
+void QueensBatchCounter::count() {
+    numTotal = numNodes = 0;
+    splitColumn = max(kMinSplitColumn, min(dimension / kSplitColumnDivisor, dimension - 2));
+    subproblems.clear();
+    split(0, 0, 0, 0, 1);
+
+    Batch batch;
+    batch.subproblems = &subproblems;
+    batch.next = 0;
+    batch.splitColumn = splitColumn;
+    batch.leafColumn = dimension - 2;
+    batch.allRows = allRows;
+    batch.numTotal = numTotal;
+    batch.numNodes = numNodes;
+
+    LaneSet lanes = LaneSet();                   // a local, so that alignas is honored
+    if (engine == kAVX2Engine) runAVX2Engine(batch, lanes);
+    else runScalarEngine(batch, lanes);
+
+    numTotal = batch.numTotal;
+    numNodes = batch.numNodes;
+    subproblems.clear();
+}
+
+/**
+ * Method: split
+ * -------------
+ * Places queens in the columns to the left of splitColumn every possible
+ * way, recording the subproblem that each placement leaves behind.  Only
+ * the lower half of the first column is tried (along with the middle row,
+ * for boards of odd dimension), and solutions below it count twice, since
+ * each has a mirror image below the upper half.  Boards too small to split
+ * are counted on the spot.
+ */
+void QueensBatchCounter::split(int col, uint64_t rows, uint64_t ascending, uint64_t descending, uint64_t weight) {
+    uint64_t safeRows = allRows & ~(rows | ascending | descending);
+    if (col == dimension) {
+        numTotal += weight;
+        return;
+    }
+    if (col == dimension - 1) {
+        numTotal += weight * __builtin_popcountll(safeRows);
+        numNodes += __builtin_popcountll(safeRows);
+        return;
+    }
+    if (col == splitColumn) {
+        Subproblem subproblem = { rows, ascending, descending, weight };
+        subproblems.push_back(subproblem);
+        return;
+    }
+
+    if (col == 0) safeRows &= (uint64_t(1) << ((dimension + 1) / 2)) - 1;
+    while (safeRows != 0) {
+        uint64_t queen = safeRows & -safeRows;
+        safeRows ^= queen;
+        uint64_t queenWeight = weight;
+        if (col == 0) queenWeight = dimension % 2 == 1 && queen == uint64_t(1) << (dimension / 2) ? 1 : 2;
+        numNodes++;
+        split(col + 1, rows | queen, ((ascending | queen) << 1) & allRows, (descending | queen) >> 1, queenWeight);
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * File: queens-batch.h
+ * --------------------
+ * Defines the QueensBatchCounter class, which counts the solutions to the
+ * N-Queens problem by exploring several subtrees at once, one per lane of
+ * a SIMD register.  Near the leaves, the ordinary search spends most of its
+ * time on tiny subtrees explored one after another, and every step ends in
+ * a branch the processor can't predict.  Here, the top of the tree is
+ * instead cut into many independent subproblems, and each lane runs a
+ * depth-first search of its own subproblem, stepping in lockstep with the
+ * other lanes.  Each step is computed for all lanes with the same branch-free
+ * instructions (a lane that places a queen and a lane that backtracks simply
+ * select different results), so the only branches left are the rare ones
+ * taken when a lane finishes its subproblem and needs another.  Processors
+ * without the vector instructions search the same subproblems one at a time.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Type: QueensBatchEngine
+ * -----------------------
+ * Identifies the instructions used to search the subproblems.  kScalarEngine
+ * runs on any processor, searching one subproblem at a time with ordinary
+ * integer instructions, and kAVX2Engine searches eight at once (four to a
+ * register) with AVX2 vector instructions, which only some x86 processors
+ * support.  kBestEngine picks the fastest engine the processor supports.
+ */
+enum QueensBatchEngine {
+    kBestEngine,
+    kScalarEngine,
+    kAVX2Engine
+};
+
+/**
+ * Class: QueensBatchCounter
+ * -------------------------
+ * Counts every solution for boards of dimension 1 through
+ * kMaxBitboardDimension.  Unlike QueensCounter, it doesn't tell unique
+ * solutions apart, though it does use the mirror symmetry of the board to
+ * search only half of the tree.
+ */
+class QueensBatchCounter {
+public:
+
+    /**
+     * Constructor: QueensBatchCounter
+     * -------------------------------
+     * Constructs a counter for a square board of the provided dimension,
+     * which searches using the provided engine.  If the processor
+     * doesn't support that engine, kScalarEngine is used instead.
+     */
+    QueensBatchCounter(int dimension, QueensBatchEngine engine = kBestEngine);
+
+    /**
+     * Method: count
+     * -------------
+     * Searches the entire tree, after which getTotalCount and getNodeCount
+     * report the results of that search.
+     */
+    void count();
+
+    /**
+     * Method: getTotalCount
+     * ---------------------
+     * Returns the number of distinct solutions to the problem.
+     */
+    uint64_t getTotalCount() const { return numTotal; }
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of queens placed over the course of the search.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+    /**
+     * Method: getEngine
+     * -----------------
+     * Returns the engine actually used to search the subproblems.
+     */
+    QueensBatchEngine getEngine() const { return engine; }
+
+    /**
+     * Method: isEngineSupported
+     * -------------------------
+     * Returns true if and only if the processor running the program
+     * supports the specified engine.
+     */
+    static bool isEngineSupported(QueensBatchEngine engine);
+
+    /**
+     * Method: getEngineName
+     * ---------------------
+     * Returns the name of the specified engine, for use in reports.
+     */
+    static const char *getEngineName(QueensBatchEngine engine);
+
+    /**
+     * Type: Subproblem
+     * ----------------
+     * Describes one subtree handed to a lane: the masks of the rows and
+     * diagonals attacked once the queens in the leftmost splitColumn columns
+     * have been placed, along with the number of solutions each solution
+     * found in it stands for (2 if its mirror image is never searched).
+     */
+    struct Subproblem {
+        uint64_t rows;
+        uint64_t ascending;
+        uint64_t descending;
+        uint64_t weight;
+    };
+
+private:
+    int dimension;
+    QueensBatchEngine engine;
+    uint64_t allRows;
+    int splitColumn;
+    std::vector<Subproblem> subproblems;
+    uint64_t numTotal;
+    uint64_t numNodes;
+
+    void split(int col, uint64_t rows, uint64_t ascending, uint64_t descending, uint64_t weight);
+};
@@ -0,0 +1,37 @@
+/**
+ * File: queens-bitboard.cpp
+ * -------------------------
+ * Presents the implementation of the non-template QueensBitboard methods.
+ * The search itself lives in queens-bitboard.h, since it's templated on
+ * the type of observer it reports to.
+ */
+
+#include "queens-bitboard.h"
+#include "queens-constants.h"
+using namespace std;
+
+QueensBitboard::QueensBitboard(int dimension) :
+    dimension(dimension),
+    allRows(dimension == kMaxBitboardDimension ? ~uint64_t(0) : (uint64_t(1) << dimension) - 1),
+    queens(dimension, -1),
+    numNodes(0) {}
+
+/**
+ * Method: placePrefix
+ * -------------------
+ * Places the queens in the provided prefix, initializing the three masks
+ * to describe the board that results.  Returns false, without placing
+ * everything, if any two of the prefix's queens attack one another.
+ */
+bool QueensBitboard::placePrefix(const vector<int>& prefix, uint64_t& rows, uint64_t& ascending, uint64_t& descending) {
+    rows = ascending = descending = 0;
+    for (int col = 0; col < (int) prefix.size(); col++) {
+        uint64_t queen = uint64_t(1) << prefix[col];
+        if ((rows | ascending | descending) & queen) return false;
+        queens[col] = prefix[col];
+        rows |= queen;
+        ascending = ((ascending | queen) << 1) & allRows;
+        descending = (descending | queen) >> 1;
+    }
+    return true;
+}
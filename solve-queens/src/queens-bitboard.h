@@ -0,0 +1,220 @@
+/**
+ * File: queens-bitboard.h
+ * -----------------------
+ * Defines the QueensBitboard class, which solves the N-Queens problem
+ * without ever scanning a board.  The rows and both diagonals already
+ * under attack are tracked as 64-bit masks, so deciding whether a cell
+ * is safe is a single bitwise operation, and the next safe row is
+ * surfaced by extracting the lowest set bit of the mask of free rows.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "backtracking.h"
+#include "queens-constants.h"
+#include "queens-observers.h"
+
+/**
+ * Function: lowestSetBitIndex
+ * ---------------------------
+ * Returns the index of the least significant 1 bit in the provided mask,
+ * which must be nonzero.
+ */
+inline int lowestSetBitIndex(uint64_t mask) {
+    return __builtin_ctzll(mask);
+}
+
+/**
+ * Class: QueensBitboard
+ * ---------------------
+ * Searches for a placement of dimension queens on a dimension x dimension
+ * board, where dimension can be as large as 64.  Queens are placed one column
+ * at a time, just as they are in the Grid<bool> version, but the attacked
+ * rows are computed rather than discovered.  The search is a Backtracker
+ * (see backtracking.h) whose variables are the columns and whose values
+ * are the rows.  The solver reports its progress to an observer, which can
+ * be a QueensDisplay when the search is animated or one of the classes in
+ * queens-observers.h when it isn't.
+ */
+class QueensBitboard {
+public:
+
+    /**
+     * Constructor: QueensBitboard
+     * ---------------------------
+     * Constructs a solver for a square board of the provided dimension,
+     * which must be between 1 and kMaxBitboardDimension, inclusive.
+     */
+    QueensBitboard(int dimension);
+
+    /**
+     * Method: solve
+     * -------------
+     * Searches for a solution, returning true if and only if one was found.
+     * If true is returned, getRow reports where each queen was placed.  The
+     * second version reports each step of the search to the provided observer.
+     */
+    bool solve();
+    template <typename Observer>
+    bool solve(Observer& observer);
+
+    /**
+     * Method: solveFrom
+     * -----------------
+     * Searches for a solution that extends the provided placement of queens
+     * in the leftmost prefix.size() columns, returning true if and only if
+     * one was found.  Unlike solve, solveFrom adds to the node count rather
+     * than resetting it, so one solver can be used for many prefixes.
+     */
+    bool solveFrom(const std::vector<int>& prefix);
+    template <typename Observer>
+    bool solveFrom(const std::vector<int>& prefix, Observer& observer);
+
+    /**
+     * Method: getDimension
+     * --------------------
+     * Returns the number of rows (and columns) on the board.
+     */
+    int getDimension() const { return dimension; }
+
+    /**
+     * Method: getRow
+     * --------------
+     * Returns the row of the queen placed in the specified column by the
+     * most recent successful call to solve.
+     */
+    int getRow(int col) const { return queens[col]; }
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of queens placed (provisionally or otherwise)
+     * by the most recent call to solve.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+    /**
+     * Class: QueensBitboard::Problem
+     * ------------------------------
+     * Presents the solver's board to a Backtracker, or to a
+     * ParallelBacktracker (see parallel-backtracking.h) with one solver and
+     * problem per thread, as it stands with the provided masks and queens
+     * placed up to the provided column.  The masks are kept for every
+     * column filled so far, and the queens themselves are in the solver's
+     * queens vector, so all the trail has to hold is how many queens have
+     * been placed, and undoing any number of them just moves back to the
+     * column that count says to.
+     */
+    class Problem {
+    public:
+        typedef int Variable;          // a column
+        typedef int Value;             // a row
+        typedef uint64_t Values;       // the safe rows not yet tried
+        struct Trail {
+            int count;                 // queens placed since firstCol
+            size_t size() const { return count; }
+        };
+
+        Problem(QueensBitboard& solver, int col, uint64_t rows, uint64_t ascending, uint64_t descending) :
+            dimension(solver.dimension), allRows(solver.allRows), queens(solver.queens.data()), firstCol(col),
+            col(col) {
+            this->rows[col] = rows;
+            this->ascending[col] = ascending;
+            this->descending[col] = descending;
+        }
+
+        bool propagate(Trail&) { return true; }
+        bool chooseVariable(int& col) const {
+            col = this->col;
+            return col < dimension;
+        }
+        uint64_t getValues(int col) const { return allRows & ~(rows[col] | ascending[col] | descending[col]); }
+        static bool nextValue(uint64_t& safeRows, int& row) {
+            if (safeRows == 0) return false;
+            row = lowestSetBitIndex(safeRows);
+            safeRows &= safeRows - 1;
+            return true;
+        }
+        void apply(int col, int row, Trail& trail);
+        void undo(Trail& trail, size_t size);
+        void keep(const Trail&, size_t, size_t) {}
+
+    private:
+        int dimension;
+        uint64_t allRows;
+        int *queens;
+        int firstCol;
+        int col;
+        uint64_t rows[kMaxBitboardDimension + 1];          // the masks, one of each per column
+        uint64_t ascending[kMaxBitboardDimension + 1];
+        uint64_t descending[kMaxBitboardDimension + 1];
+    };
+
+private:
+    int dimension;
+    uint64_t allRows;        // one bit for each of the dimension rows
+    std::vector<int> queens; // queens[col] is the row of the queen in column col
+    uint64_t numNodes;
+
+    bool placePrefix(const std::vector<int>& prefix, uint64_t& rows, uint64_t& ascending, uint64_t& descending);
+};
+
+/*
+ * Implementation notes: QueensBitboard templates
+ * ----------------------------------------------
+ * Bit r of each mask speaks for row r of the column currently being filled.
+ * rows records the rows already holding a queen, ascending records the rows
+ * attacked along the up-and-to-the-right diagonals, and descending records
+ * the rows attacked along the down-and-to-the-right ones.  Moving one column
+ * to the right shifts each diagonal one row further along, which is all it
+ * takes to keep the masks current.
+ */
+
+inline bool QueensBitboard::solve() {
+    NullQueensObserver observer;
+    return solve(observer);
+}
+
+template <typename Observer>
+bool QueensBitboard::solve(Observer& observer) {
+    numNodes = 0;
+    return solveFrom(std::vector<int>(), observer);
+}
+
+inline bool QueensBitboard::solveFrom(const std::vector<int>& prefix) {
+    NullQueensObserver observer;
+    return solveFrom(prefix, observer);
+}
+
+template <typename Observer>
+bool QueensBitboard::solveFrom(const std::vector<int>& prefix, Observer& observer) {
+    uint64_t rows, ascending, descending;
+    if (!placePrefix(prefix, rows, ascending, descending)) return false;
+    Problem problem(*this, prefix.size(), rows, ascending, descending);
+    Problem::Trail trail = { 0 };
+    Backtracker<Problem, QueensSearchObserver<Observer> > search(problem, trail,
+                                                                 QueensSearchObserver<Observer>(observer));
+    bool isSolved = search.findFirst();
+    numNodes += search.getNodeCount();
+    if (!isSolved) std::fill(queens.begin() + prefix.size(), queens.end(), -1);
+    return isSolved;
+}
+
+inline void QueensBitboard::Problem::apply(int col, int row, Trail& trail) {
+    trail.count++;
+    uint64_t queen = uint64_t(1) << row;
+    rows[col + 1] = rows[col] | queen;
+    ascending[col + 1] = ((ascending[col] | queen) << 1) & allRows;
+    descending[col + 1] = (descending[col] | queen) >> 1;
+    queens[col] = row;
+    this->col = col + 1;
+}
+
+inline void QueensBitboard::Problem::undo(Trail& trail, size_t size) {
+    trail.count = size;
+    col = firstCol + size;
+}
@@ -0,0 +1,193 @@
+/**
+ * File: queens-completion.cpp
+ * ---------------------------
+ * Presents the implementation of readPartialPlacement and of the
+ * non-template methods of the QueensCompletion class.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include "queens-completion.h"
+using namespace std;
+
+bool readPartialPlacement(istream& in, int& dimension, vector<pair<int, int> >& queens) {
+    vector<int> numbers;
+    string line;
+    while (getline(in, line)) {
+        istringstream tokens(line.substr(0, line.find('#')));
+        int number;
+        while (tokens >> number) numbers.push_back(number);
+        if (!tokens.eof()) return false;
+    }
+    if (numbers.empty() || numbers.size() % 2 == 0 || numbers[0] < 1) return false;
+
+    dimension = numbers[0];
+    queens.clear();
+    for (size_t i = 1; i < numbers.size(); i += 2) {
+        int row = numbers[i], col = numbers[i + 1];
+        if (row < 0 || row >= dimension || col < 0 || col >= dimension) return false;
+        queens.push_back(make_pair(row, col));
+    }
+    return true;
+}
+
+QueensCompletion::QueensCompletion(int dimension, uint32_t seed) :
+    dimension(dimension),
+    rows(dimension, -1),
+    rowQueens(dimension, 0),
+    ascendingQueens(2 * dimension - 1, 0),
+    descendingQueens(2 * dimension - 1, 0),
+    columnSupport(dimension, dimension),
+    rowSupport(dimension, dimension),
+    numEmptyColumns(dimension),
+    generator(seed),
+    numNodes(0),
+    nodeLimit(0),
+    limitReached(false),
+    numRestarts(0) {}
+
+bool QueensCompletion::placeQueen(int row, int col) {
+    if (row < 0 || row >= dimension || col < 0 || col >= dimension || rows[col] != -1) return false;
+    addQueen(row, col);
+    preplaced.push_back(col);
+    return true;
+}
+
+/**
+ * Method: isSafe
+ * --------------
+ * Returns true if and only if no queen shares a row or diagonal with the
+ * specified cell.  (Whether its column is empty is up to the caller.)
+ */
+bool QueensCompletion::isSafe(int row, int col) const {
+    return rowQueens[row] == 0 && ascendingQueens[row + col] == 0 && descendingQueens[row - col + dimension - 1] == 0;
+}
+
+/**
+ * Method: hasConflicts
+ * --------------------
+ * Returns true if and only if some row or diagonal holds more than one queen,
+ * which can only happen if the partial placement is already broken.
+ */
+bool QueensCompletion::hasConflicts() const {
+    return *max_element(rowQueens.begin(), rowQueens.end()) > 1 ||
+           *max_element(ascendingQueens.begin(), ascendingQueens.end()) > 1 ||
+           *max_element(descendingQueens.begin(), descendingQueens.end()) > 1;
+}
+
+/**
+ * Method: chooseLine
+ * ------------------
+ * Finds the empty column or empty row with the fewest safe cells, setting
+ * isRow and index to identify it, and breaking ties at random.  Returns false
+ * if some empty column or row has no safe cells at all, in which case the
+ * search has reached a dead end.
+ */
+bool QueensCompletion::chooseLine(bool& isRow, int& index) {
+    int fewest = dimension + 1;
+    int numTied = 0;
+    for (int line = 0; line < 2 * dimension; line++) {
+        bool lineIsRow = line >= dimension;
+        int lineIndex = lineIsRow ? line - dimension : line;
+        if (lineIsRow ? rowQueens[lineIndex] != 0 : rows[lineIndex] != -1) continue;
+        int support = lineIsRow ? rowSupport[lineIndex] : columnSupport[lineIndex];
+        if (support > fewest) continue;
+        if (support < fewest) {
+            fewest = support;
+            numTied = 0;
+        }
+        // keeps each of the tied lines with equal probability
+        if (uniform_int_distribution<int>(0, numTied++)(generator) == 0) {
+            isRow = lineIsRow;
+            index = lineIndex;
+        }
+    }
+    return fewest > 0;
+}
+
+/**
+ * Method: addQueen
+ * ----------------
+ * Places a queen in the specified cell, whose column must be empty.  The
+ * column's safe cells stop counting toward the support of their rows, and
+ * then each line through the queen that wasn't already under attack becomes
+ * so, which takes away the safe cells along it.  Raising each line's counter
+ * only after it's been processed ensures that a cell on two of the lines
+ * is only taken away once.
+ */
+void QueensCompletion::addQueen(int row, int col) {
+    for (int other = 0; other < dimension; other++) {
+        if (isSafe(other, col)) rowSupport[other]--;
+    }
+    rows[col] = row;
+    numEmptyColumns--;
+
+    int ascending = row + col, descending = row - col + dimension - 1;
+    if (rowQueens[row] == 0) attackLine(0, dimension - 1, row, 0);
+    rowQueens[row]++;
+    if (ascendingQueens[ascending] == 0) {
+        int first = max(0, ascending - (dimension - 1));
+        attackLine(first, min(dimension - 1, ascending), ascending - first, -1);
+    }
+    ascendingQueens[ascending]++;
+    if (descendingQueens[descending] == 0) {
+        int first = max(0, col - row);
+        attackLine(first, min(dimension - 1, dimension - 1 + col - row), first + row - col, 1);
+    }
+    descendingQueens[descending]++;
+}
+
+/**
+ * Method: removeQueen
+ * -------------------
+ * Reverses the effects of addQueen, in the opposite order.
+ */
+void QueensCompletion::removeQueen(int row, int col) {
+    int ascending = row + col, descending = row - col + dimension - 1;
+    if (--descendingQueens[descending] == 0) {
+        int first = max(0, col - row);
+        releaseLine(first, min(dimension - 1, dimension - 1 + col - row), first + row - col, 1);
+    }
+    if (--ascendingQueens[ascending] == 0) {
+        int first = max(0, ascending - (dimension - 1));
+        releaseLine(first, min(dimension - 1, ascending), ascending - first, -1);
+    }
+    if (--rowQueens[row] == 0) releaseLine(0, dimension - 1, row, 0);
+
+    rows[col] = -1;
+    numEmptyColumns++;
+    columnSupport[col] = 0;
+    for (int other = 0; other < dimension; other++) {
+        if (isSafe(other, col)) {
+            rowSupport[other]++;
+            columnSupport[col]++;
+        }
+    }
+}
+
+/**
+ * Methods: attackLine, releaseLine
+ * --------------------------------
+ * Walk the cells of a row or diagonal in the empty columns from first to
+ * last, where the cell in column first is in the specified row and each
+ * column to the right moves rowStep rows, taking away (or giving back) the
+ * support of each cell that's currently safe.
+ */
+void QueensCompletion::attackLine(int first, int last, int row, int rowStep) {
+    for (int col = first; col <= last; col++, row += rowStep) {
+        if (rows[col] == -1 && isSafe(row, col)) {
+            columnSupport[col]--;
+            rowSupport[row]--;
+        }
+    }
+}
+
+void QueensCompletion::releaseLine(int first, int last, int row, int rowStep) {
+    for (int col = first; col <= last; col++, row += rowStep) {
+        if (rows[col] == -1 && isSafe(row, col)) {
+            columnSupport[col]++;
+            rowSupport[row]++;
+        }
+    }
+}
@@ -0,0 +1,226 @@
+/**
+ * File: queens-completion.h
+ * -------------------------
+ * Defines the QueensCompletion class, which solves the completion variant
+ * of the N-Queens problem: given queens already placed on some of the
+ * columns, place the rest so that no two queens attack one another, or
+ * prove that it can't be done.  Unlike the problem on an empty board, which
+ * always has a solution for dimension 4 and up, the completion problem is
+ * NP-complete, so the search has to prune aggressively to get anywhere.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include "queens-observers.h"
+
+/* Constants */
+static const uint64_t kInitialNodeLimit = 1000; // nodes the first run may visit before restarting
+static const uint64_t kNodeLimitGrowth = 2;     // factor by which the limit grows with each restart
+
+/**
+ * Function: readPartialPlacement
+ * ------------------------------
+ * Reads a partial placement from the provided stream.  The stream holds the
+ * dimension of the board followed by the row and column (counting from 0)
+ * of each queen already placed, all separated by whitespace.  Everything
+ * from a # to the end of its line is ignored.  Returns false if the stream
+ * doesn't hold a dimension followed by pairs of coordinates on the board.
+ */
+bool readPartialPlacement(std::istream& in, int& dimension, std::vector<std::pair<int, int> >& queens);
+
+/**
+ * Class: QueensCompletion
+ * -----------------------
+ * Extends a partial placement to a full one, for boards of any dimension.
+ * The number of queens on every row and diagonal is tracked by counters
+ * updated in O(1) time as queens come and go, so that whether a cell is
+ * safe never requires a scan of the board.  The search also tracks, for
+ * every empty column, how many of its cells are safe, and for every empty
+ * row, how many safe cells it has in the empty columns.  Every row and every
+ * column must eventually hold a queen, so the search backtracks as soon as
+ * any of those counts falls to zero, and otherwise branches on the row or
+ * column with the fewest safe cells, which places forced queens right away.
+ *
+ * Backtracking searches on large boards are prone to wander into enormous
+ * subtrees with no solution in them, even when solutions are plentiful, so
+ * ties are broken and candidates are ordered at random, and the search is
+ * restarted whenever it places more queens than it's allowed.  The allowance
+ * grows with every restart, so that eventually a search runs to completion,
+ * which is what proves that a placement can't be extended.
+ */
+class QueensCompletion {
+public:
+
+    /**
+     * Constructor: QueensCompletion
+     * -----------------------------
+     * Constructs a solver for an empty square board of the provided dimension.
+     * The seed determines the sequence of random choices, so equal seeds
+     * produce equal solutions.
+     */
+    QueensCompletion(int dimension, uint32_t seed = 1);
+
+    /**
+     * Method: placeQueen
+     * ------------------
+     * Places one of the queens of the partial placement.  Returns false,
+     * without placing the queen, if the cell is off the board or its column
+     * already holds a queen.  (Queens that attack one another are accepted,
+     * since solve is the one that should report that they can't be extended.)
+     */
+    bool placeQueen(int row, int col);
+
+    /**
+     * Method: solve
+     * -------------
+     * Searches for a way to fill every empty column, returning true if and
+     * only if one was found.  If true is returned, getRow reports where every
+     * queen is, and if false is returned, the partial placement provably
+     * can't be completed.  The second version reports the queens placed in
+     * advance, followed by every step of the search, to the provided observer.
+     */
+    bool solve();
+    template <typename Observer>
+    bool solve(Observer& observer);
+
+    /**
+     * Method: getDimension
+     * --------------------
+     * Returns the dimension of the board.
+     */
+    int getDimension() const { return dimension; }
+
+    /**
+     * Method: getRow
+     * --------------
+     * Returns the row of the queen in the specified column, or -1 if the
+     * column is empty.
+     */
+    int getRow(int col) const { return rows[col]; }
+
+    /**
+     * Method: getRows
+     * ---------------
+     * Returns the row of the queen in every column, where empty columns
+     * report -1.
+     */
+    const std::vector<int>& getRows() const { return rows; }
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of queens placed during the most recent call to
+     * solve, over all of its restarts.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+    /**
+     * Method: getRestartCount
+     * -----------------------
+     * Returns the number of times the most recent call to solve started over.
+     */
+    int getRestartCount() const { return numRestarts; }
+
+private:
+    int dimension;
+    std::vector<int> rows;               // rows[col] is the row of the queen in column col, or -1
+    std::vector<int> rowQueens;          // rowQueens[row] counts the queens in each row
+    std::vector<int> ascendingQueens;    // ascendingQueens[row + col] counts the queens on each / diagonal
+    std::vector<int> descendingQueens;   // descendingQueens[row - col + dimension - 1] counts those on each \ diagonal
+    std::vector<int> columnSupport;      // columnSupport[col] counts the safe cells in each empty column
+    std::vector<int> rowSupport;         // rowSupport[row] counts the safe cells each row has in empty columns
+    std::vector<int> preplaced;          // the columns whose queens were placed before the search began
+    int numEmptyColumns;
+    std::mt19937 generator;
+    uint64_t numNodes;
+    uint64_t nodeLimit;                  // the number of nodes at which the current run gives up
+    bool limitReached;
+    int numRestarts;
+
+    bool isSafe(int row, int col) const;
+    bool hasConflicts() const;
+    bool chooseLine(bool& isRow, int& index);
+    void addQueen(int row, int col);
+    void removeQueen(int row, int col);
+    void attackLine(int first, int last, int row, int rowStep);
+    void releaseLine(int first, int last, int row, int rowStep);
+    template <typename Observer>
+    bool search(Observer& observer);
+    template <typename Observer>
+    bool tryQueen(Observer& observer, int row, int col);
+};
+
+/*
+ * Implementation notes: QueensCompletion templates
+ * ------------------------------------------------
+ * The search fills empty columns until none remain.  chooseLine picks either
+ * an empty column or an empty row, and its safe cells are tried in random
+ * order; either way, one of them must hold a queen in any completion.  A run
+ * that reaches its node limit unwinds completely, reporting the removal of
+ * every queen it placed, before the next run begins.
+ */
+
+inline bool QueensCompletion::solve() {
+    NullQueensObserver observer;
+    return solve(observer);
+}
+
+template <typename Observer>
+bool QueensCompletion::solve(Observer& observer) {
+    numNodes = 0;
+    numRestarts = 0;
+    for (int col: preplaced) observer.permanentlyPlaceQueen(rows[col], col);
+    if (hasConflicts()) return false;
+    for (nodeLimit = kInitialNodeLimit; ; nodeLimit = numNodes + nodeLimit * kNodeLimitGrowth) {
+        limitReached = false;
+        if (search(observer)) return true;
+        if (!limitReached) return false;
+        numRestarts++;
+    }
+}
+
+template <typename Observer>
+bool QueensCompletion::search(Observer& observer) {
+    if (numEmptyColumns == 0) return true;
+    if (numNodes >= nodeLimit) {
+        limitReached = true;
+        return false;
+    }
+    bool isRow;
+    int index;
+    if (!chooseLine(isRow, index)) return false;
+
+    std::vector<int> others;
+    for (int other = 0; other < dimension; other++) {
+        int row = isRow ? index : other;
+        int col = isRow ? other : index;
+        if (rows[col] == -1 && isSafe(row, col)) others.push_back(other);
+    }
+    std::shuffle(others.begin(), others.end(), generator);
+    for (int other: others) {
+        if (tryQueen(observer, isRow ? index : other, isRow ? other : index)) return true;
+        if (limitReached) return false;
+    }
+    return false;
+}
+
+template <typename Observer>
+bool QueensCompletion::tryQueen(Observer& observer, int row, int col) {
+    numNodes++;
+    observer.considerQueen(row, col);
+    addQueen(row, col);
+    observer.provisionallyPlaceQueen(row, col);
+    if (search(observer)) {
+        observer.permanentlyPlaceQueen(row, col);
+        return true;
+    }
+    removeQueen(row, col);
+    observer.removeQueen(row, col);
+    return false;
+}
@@ -9,4 +9,7 @@
 
 /* Constants (self-explanatory) */
 static const int kMinBoardDimension = 4;
-static const int kMaxBoardDimension = 10;
+static const int kMaxBoardDimension = 10;     // largest board that's animated
+static const int kMaxBitboardDimension = 64;  // one bit per row in a uint64_t
+static const int kMaxSearchDimension = 32;    // largest board searched for a solution in seconds
+static const int kMaxCountDimension = 16;     // largest board whose solutions are counted in seconds
@@ -0,0 +1,146 @@
+/**
+ * File: queens-counter.cpp
+ * ------------------------
+ * Presents the implementation of the QueensCounter class.  The vertical
+ * reflection of a solution is always another solution, so the first queen
+ * is only ever placed in the lower half of the first column (and in the
+ * middle row, when there is one).  Every solution is still accounted for,
+ * because the lexicographically smallest of the eight symmetric variants
+ * of any solution has its first queen in that lower half.  That smallest
+ * variant is the one we count as unique, weighting it by the number of
+ * distinct variants it stands for.
+ */
+
+#include "queens-counter.h"
+#include "queens-bitboard.h"
+#include "queens-constants.h"
+using namespace std;
+
+QueensCounter::QueensCounter(int dimension) :
+    dimension(dimension),
+    allRows(dimension == kMaxBitboardDimension ? ~uint64_t(0) : (uint64_t(1) << dimension) - 1),
+    queens(dimension, -1),
+    columns(dimension, -1),
+    numTotal(0),
+    numUnique(0),
+    numNodes(0) {}
+
+void QueensCounter::count() {
+    reset();
+    int firstRowLimit = (dimension + 1) / 2;
+    for (int row = 0; row < firstRowLimit; row++) {
+        countFrom(vector<int>(1, row));
+    }
+}
+
+void QueensCounter::countFrom(const vector<int>& prefix) {
+    uint64_t rows = 0, ascending = 0, descending = 0;
+    for (int col = 0; col < (int) prefix.size(); col++) {
+        uint64_t queen = uint64_t(1) << prefix[col];
+        if ((rows | ascending | descending) & queen) return;
+        queens[col] = prefix[col];
+        numNodes++;
+        rows |= queen;
+        ascending = ((ascending | queen) << 1) & allRows;
+        descending = (descending | queen) >> 1;
+    }
+    search(prefix.size(), rows, ascending, descending);
+}
+
+void QueensCounter::search(int col, uint64_t rows, uint64_t ascending, uint64_t descending) {
+    if (col == dimension) {
+        recordSolution();
+        return;
+    }
+
+    uint64_t safeRows = allRows & ~(rows | ascending | descending);
+    while (safeRows != 0) {
+        uint64_t queen = safeRows & -safeRows;
+        safeRows ^= queen;
+        queens[col] = lowestSetBitIndex(queen);
+        numNodes++;
+        search(col + 1, rows | queen, ((ascending | queen) << 1) & allRows, (descending | queen) >> 1);
+    }
+}
+
+/**
+ * Method: recordSolution
+ * ----------------------
+ * Folds the solution currently in queens into the running totals, and
+ * hands it (and its reflection, which the search will never visit) to
+ * the listener, if there is one.
+ */
+void QueensCounter::recordSolution() {
+    int numSymmetries = countSymmetries();
+    if (numSymmetries > 0) {
+        numUnique++;
+        numTotal += 8 / numSymmetries;
+    }
+    if (listener) reportSolution();
+}
+
+/**
+ * Function: transformedRow
+ * ------------------------
+ * Returns the row of the queen in column col once the board has been
+ * put through the specified rotation or reflection.  queens and columns
+ * are inverse permutations describing the original board, and last is
+ * the index of its last row and column.
+ */
+static int transformedRow(int transform, const vector<int>& queens, const vector<int>& columns, int col, int last) {
+    switch (transform) {
+        case 1: return columns[last - col];         // rotate 90 degrees
+        case 2: return last - queens[last - col];   // rotate 180 degrees
+        case 3: return last - columns[col];         // rotate 270 degrees
+        case 4: return last - queens[col];          // reflect top to bottom
+        case 5: return queens[last - col];          // reflect left to right
+        case 6: return columns[col];                // reflect across the main diagonal
+        default: return last - columns[last - col]; // reflect across the other diagonal
+    }
+}
+
+/**
+ * Method: countSymmetries
+ * -----------------------
+ * Returns 0 if some rotation or reflection of the solution in queens is
+ * lexicographically smaller than it is.  Otherwise, returns the number of
+ * the eight symmetries of the square that leave the solution unchanged
+ * (always 1, 2, or 4).
+ */
+int QueensCounter::countSymmetries() {
+    int last = dimension - 1;
+    for (int col = 0; col < dimension; col++) {
+        columns[queens[col]] = col;
+    }
+
+    int numSymmetries = 1;
+    for (int transform = 1; transform < 8; transform++) {
+        int col = 0;
+        while (col < dimension && transformedRow(transform, queens, columns, col, last) == queens[col]) {
+            col++;
+        }
+        if (col == dimension) {
+            numSymmetries++;
+        } else if (transformedRow(transform, queens, columns, col, last) < queens[col]) {
+            return 0;
+        }
+    }
+    return numSymmetries;
+}
+
+/**
+ * Method: reportSolution
+ * ----------------------
+ * Hands the current solution to the listener, followed by its reflection
+ * whenever the search itself would never produce that reflection.
+ */
+void QueensCounter::reportSolution() {
+    listener(queens);
+    int last = dimension - 1;
+    if (2 * queens[0] == last) return; // reflection also starts in the middle row
+    vector<int> reflection(dimension);
+    for (int col = 0; col < dimension; col++) {
+        reflection[col] = last - queens[col];
+    }
+    listener(reflection);
+}
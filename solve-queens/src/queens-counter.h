@@ -0,0 +1,115 @@
+/**
+ * File: queens-counter.h
+ * ----------------------
+ * Defines the QueensCounter class, which counts (and optionally lists)
+ * every solution to the N-Queens problem rather than stopping at the first.
+ * The search leans on the symmetries of the board: only solutions whose
+ * first queen sits in the lower half of the first column are ever searched
+ * for, and each of those is checked against the seven other rotations and
+ * reflections of the board so that unique solutions can be reported along
+ * with the total.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Class: QueensCounter
+ * --------------------
+ * Counts the solutions to the N-Queens problem for boards of dimension
+ * 1 through kMaxBitboardDimension, using the same bitmask representation
+ * relied on by QueensBitboard.
+ */
+class QueensCounter {
+public:
+
+    /**
+     * Type: SolutionListener
+     * ----------------------
+     * Describes a function that's handed every solution discovered by count,
+     * where solution[col] is the row of the queen placed in column col.
+     */
+    typedef std::function<void(const std::vector<int>& solution)> SolutionListener;
+
+    /**
+     * Constructor: QueensCounter
+     * --------------------------
+     * Constructs a counter for a square board of the provided dimension.
+     */
+    QueensCounter(int dimension);
+
+    /**
+     * Method: setSolutionListener
+     * ---------------------------
+     * Arranges for the provided listener to be handed every one of the
+     * solutions, symmetric variants included, as count discovers them.
+     */
+    void setSolutionListener(const SolutionListener& listener) { this->listener = listener; }
+
+    /**
+     * Method: count
+     * -------------
+     * Searches the entire tree, after which the getters below report the
+     * results of that search.
+     */
+    void count();
+
+    /**
+     * Method: countFrom
+     * -----------------
+     * Searches just the subtree below the provided placement of queens in the
+     * leftmost prefix.size() columns, adding what it finds to the running
+     * totals rather than replacing them.  Every solution is accounted for
+     * provided the prefixes passed over a series of calls (starting from a
+     * freshly constructed or reset counter) cover the solutions whose first
+     * queen lies in the lower half of the first column.
+     */
+    void countFrom(const std::vector<int>& prefix);
+
+    /**
+     * Method: reset
+     * -------------
+     * Zeroes the totals and the node count.
+     */
+    void reset() { numTotal = numUnique = numNodes = 0; }
+
+    /**
+     * Method: getTotalCount
+     * ---------------------
+     * Returns the number of distinct solutions to the problem.
+     */
+    uint64_t getTotalCount() const { return numTotal; }
+
+    /**
+     * Method: getUniqueCount
+     * ----------------------
+     * Returns the number of solutions that remain once those that are
+     * rotations or reflections of one another are considered the same.
+     */
+    uint64_t getUniqueCount() const { return numUnique; }
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of queens placed over the course of the search.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+private:
+    int dimension;
+    uint64_t allRows;
+    std::vector<int> queens;   // queens[col] is the row of the queen in column col
+    std::vector<int> columns;  // columns[row] is the column of the queen in row row
+    SolutionListener listener;
+    uint64_t numTotal;
+    uint64_t numUnique;
+    uint64_t numNodes;
+
+    void search(int col, uint64_t rows, uint64_t ascending, uint64_t descending);
+    void recordSolution();
+    int countSymmetries();
+    void reportSolution();
+};
@@ -0,0 +1,52 @@
+/**
+ * File: queens-enumerator.cpp
+ * ---------------------------
+ * Presents the implementation of the QueensEnumerator class.  The explicit
+ * stack mirrors the frames of the recursive QueensBitboard search: frame col
+ * holds the three attack masks for column col along with the safe rows that
+ * haven't been tried there yet.  Placing a queen pushes a frame, and running
+ * out of rows to try pops one.
+ */
+
+#include "queens-enumerator.h"
+#include "queens-bitboard.h"
+#include "queens-constants.h"
+using namespace std;
+
+QueensEnumerator::QueensEnumerator(int dimension) :
+    dimension(dimension),
+    allRows(dimension == kMaxBitboardDimension ? ~uint64_t(0) : (uint64_t(1) << dimension) - 1),
+    depth(0),
+    queens(dimension, -1),
+    rows(dimension + 1, 0),
+    ascending(dimension + 1, 0),
+    descending(dimension + 1, 0),
+    untried(dimension + 1, 0),
+    numNodes(0) {
+    untried[0] = allRows;
+}
+
+bool QueensEnumerator::next() {
+    if (depth == dimension) depth--; // resume just after the solution last produced
+    while (depth >= 0) {
+        if (untried[depth] == 0) {
+            depth--;
+            continue;
+        }
+
+        uint64_t queen = untried[depth] & -untried[depth];
+        untried[depth] ^= queen;
+        queens[depth] = lowestSetBitIndex(queen);
+        numNodes++;
+
+        rows[depth + 1] = rows[depth] | queen;
+        ascending[depth + 1] = ((ascending[depth] | queen) << 1) & allRows;
+        descending[depth + 1] = (descending[depth] | queen) >> 1;
+        depth++;
+        if (depth == dimension) return true;
+        untried[depth] = allRows & ~(rows[depth] | ascending[depth] | descending[depth]);
+    }
+
+    depth = -1; // stay exhausted no matter how many more times next is called
+    return false;
+}
@@ -0,0 +1,116 @@
+/**
+ * File: queens-enumerator.h
+ * -------------------------
+ * Defines the QueensEnumerator class, which produces the solutions to the
+ * N-Queens problem one at a time, on demand.  Unlike the recursive solvers,
+ * which bury the state of the search in the call stack, the enumerator keeps
+ * the search state in a small explicit stack of bitmasks, so it can stop after
+ * any solution and pick up exactly where it left off when asked for the next.
+ * Nothing but the current solution is ever materialized.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * Class: QueensEnumerator
+ * -----------------------
+ * Enumerates every solution to the N-Queens problem, in lexicographic
+ * order, for boards of dimension 1 through kMaxBitboardDimension.  Solutions
+ * can be pulled by calling next and current directly:
+ *
+ *     QueensEnumerator enumerator(dimension);
+ *     while (enumerator.next()) {
+ *         process(enumerator.current());
+ *     }
+ *
+ * or by iterating over the enumerator, which does the same thing:
+ *
+ *     for (const vector<int>& solution: enumerator) process(solution);
+ */
+class QueensEnumerator {
+public:
+
+    /**
+     * Constructor: QueensEnumerator
+     * -----------------------------
+     * Constructs an enumerator for a square board of the provided dimension,
+     * positioned before the first solution.
+     */
+    QueensEnumerator(int dimension);
+
+    /**
+     * Method: next
+     * ------------
+     * Advances to the next solution, returning true if there was one and
+     * false if every solution has already been produced.
+     */
+    bool next();
+
+    /**
+     * Method: current
+     * ---------------
+     * Returns the solution most recently surfaced by next, where
+     * solution[col] is the row of the queen in column col.
+     */
+    const std::vector<int>& current() const { return queens; }
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of queens placed so far.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+    /**
+     * Class: QueensEnumerator::iterator
+     * ---------------------------------
+     * An input iterator over the solutions that remain.  Advancing any
+     * iterator advances the enumerator itself.
+     */
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef std::vector<int> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::vector<int> *pointer;
+        typedef const std::vector<int>& reference;
+
+        iterator(QueensEnumerator *enumerator = NULL) : enumerator(enumerator) {}
+        const std::vector<int>& operator*() const { return enumerator->current(); }
+        const std::vector<int> *operator->() const { return &enumerator->current(); }
+        iterator& operator++() {
+            if (!enumerator->next()) enumerator = NULL;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return enumerator == other.enumerator; }
+        bool operator!=(const iterator& other) const { return enumerator != other.enumerator; }
+
+    private:
+        QueensEnumerator *enumerator; // NULL once the solutions run out
+    };
+
+    /**
+     * Methods: begin, end
+     * -------------------
+     * Support range-based for loops over the remaining solutions.  begin
+     * advances to the next solution.
+     */
+    iterator begin() { return next() ? iterator(this) : iterator(); }
+    iterator end() { return iterator(); }
+
+private:
+    int dimension;
+    uint64_t allRows;
+    int depth;                      // number of queens currently placed
+    std::vector<int> queens;        // queens[col] is the row of the queen in column col
+    std::vector<uint64_t> rows;     // rows[col] is the mask of rows attacked in column col
+    std::vector<uint64_t> ascending;
+    std::vector<uint64_t> descending;
+    std::vector<uint64_t> untried;  // untried[col] are the safe rows in column col not yet tried
+    uint64_t numNodes;
+};
@@ -0,0 +1,197 @@
+/**
+ * File: queens-large.cpp
+ * ----------------------
+ * Presents the implementation of the explicit construction and of the
+ * QueensMinConflicts class.  The local search follows the approach of
+ * Sosic and Gu's QS4: queens are first placed column by column, each in a
+ * randomly chosen unused row that leaves its diagonals empty, and only the
+ * last few columns, where such rows are scarce, are filled without regard
+ * to conflicts.  The conflicts that remain are then repaired by swapping.
+ */
+
+#include <algorithm>
+#include "queens-large.h"
+using namespace std;
+
+/* Constants */
+static const int kAttemptsPerColumn = 64;      // random rows tried before settling for a conflict
+static const int kPatiencePerColumn = 4;       // trades without progress allowed per column before restarting
+
+vector<int> constructQueens(int dimension) {
+    if (dimension == 2 || dimension == 3) return vector<int>();
+    vector<int> evens, odds;
+    for (int row = 2; row <= dimension; row += 2) evens.push_back(row);
+    for (int row = 1; row <= dimension; row += 2) odds.push_back(row);
+
+    if (dimension % 6 == 2) {
+        // 2 4 6 ... 3 1 7 9 11 ... 5
+        swap(odds[0], odds[1]);
+        odds.erase(odds.begin() + 2);
+        odds.push_back(5);
+    } else if (dimension % 6 == 3) {
+        // 4 6 8 ... 2 5 7 9 ... 1 3
+        evens.erase(evens.begin());
+        evens.push_back(2);
+        odds.erase(odds.begin(), odds.begin() + 2);
+        odds.push_back(1);
+        odds.push_back(3);
+    }
+
+    vector<int> solution;
+    solution.reserve(dimension);
+    for (int row: evens) solution.push_back(row - 1);
+    for (int row: odds) solution.push_back(row - 1);
+    return solution;
+}
+
+bool isQueensSolution(const vector<int>& rows) {
+    int dimension = rows.size();
+    vector<bool> rowUsed(dimension, false), ascendingUsed(2 * dimension, false), descendingUsed(2 * dimension, false);
+    for (int col = 0; col < dimension; col++) {
+        int row = rows[col];
+        if (row < 0 || row >= dimension) return false;
+        if (rowUsed[row] || ascendingUsed[row + col] || descendingUsed[row - col + dimension]) return false;
+        rowUsed[row] = ascendingUsed[row + col] = descendingUsed[row - col + dimension] = true;
+    }
+    return true;
+}
+
+QueensMinConflicts::QueensMinConflicts(int dimension, uint32_t seed) :
+    dimension(dimension),
+    generator(seed),
+    rows(dimension),
+    ascending(2 * dimension - 1, 0),
+    descending(2 * dimension - 1, 0),
+    numCollisions(0),
+    numSwaps(0) {}
+
+bool QueensMinConflicts::solve(uint64_t maxSwaps) {
+    numSwaps = 0;
+    if (dimension == 2 || dimension == 3) return false;
+    while (true) {
+        placeGreedily();
+        if (repair(maxSwaps)) return true;
+        if (numSwaps >= maxSwaps) return false;
+    }
+}
+
+/**
+ * Method: placeGreedily
+ * ---------------------
+ * Discards the current placement and builds a new one, column by column.
+ * Each column takes a random row from among those not yet used, preferring
+ * one whose diagonals are both empty, except for the last few columns,
+ * which just take whatever rows are left.
+ */
+void QueensMinConflicts::placeGreedily() {
+    for (int row = 0; row < dimension; row++) rows[row] = row;
+    fill(ascending.begin(), ascending.end(), 0);
+    fill(descending.begin(), descending.end(), 0);
+    numCollisions = 0;
+
+    for (int col = 0; col < dimension; col++) {
+        for (int attempt = 0; attempt < kAttemptsPerColumn; attempt++) {
+            swap(rows[col], rows[randomColumn(col, dimension - 1)]);
+            if (!isAttacked(col, 0)) break;
+        }
+        addQueen(col);
+    }
+}
+
+/**
+ * Method: repair
+ * --------------
+ * Repeatedly picks a random queen under attack and tries trading rows with
+ * a random other queen, keeping the trade unless it increases the number of
+ * collisions.  (Accepting trades that leave the count unchanged lets the
+ * search wander across plateaus rather than stall on them.)  Queens that
+ * might be under attack are kept in a list of suspects, so that finding one
+ * never requires a scan of the whole board.  Returns true once there are no
+ * collisions left, and false if too many trades go by without improvement
+ * (in which case a fresh start is the better bet) or the allotted number of
+ * trades runs out.
+ */
+bool QueensMinConflicts::repair(uint64_t maxSwaps) {
+    vector<int> suspects;
+    for (int col = 0; col < dimension; col++) {
+        if (isAttacked(col, 1)) suspects.push_back(col);
+    }
+
+    uint64_t fewestCollisions = numCollisions;
+    uint64_t patience = kPatiencePerColumn * (uint64_t) dimension;
+    uint64_t numStalledSwaps = 0;
+    while (numCollisions > 0) {
+        if (suspects.empty()) return false;
+        int index = randomColumn(0, suspects.size() - 1);
+        int col = suspects[index];
+        if (!isAttacked(col, 1)) {
+            suspects[index] = suspects.back();
+            suspects.pop_back();
+            continue;
+        }
+
+        if (numSwaps++ >= maxSwaps || numStalledSwaps++ >= patience) return false;
+        int other = randomColumn(0, dimension - 1);
+        uint64_t before = numCollisions;
+        swapRows(col, other);
+        if (numCollisions > before) {
+            swapRows(col, other);
+        } else if (isAttacked(other, 1)) {
+            suspects.push_back(other);
+        }
+        if (numCollisions < fewestCollisions) {
+            fewestCollisions = numCollisions;
+            numStalledSwaps = 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * Method: isAttacked
+ * ------------------
+ * Returns true if and only if the queen in the specified column shares
+ * a diagonal with some other queen.  (Queens never share a row.)  The
+ * minimum says how many queens (the queen itself, or none if it hasn't
+ * been added to the counters yet) can sit on each diagonal unopposed.
+ */
+bool QueensMinConflicts::isAttacked(int col, int minimum) const {
+    return ascending[rows[col] + col] > minimum || descending[rows[col] - col + dimension - 1] > minimum;
+}
+
+void QueensMinConflicts::addQueen(int col) {
+    int& onAscending = ascending[rows[col] + col];
+    int& onDescending = descending[rows[col] - col + dimension - 1];
+    if (onAscending++ > 0) numCollisions++;
+    if (onDescending++ > 0) numCollisions++;
+}
+
+void QueensMinConflicts::removeQueen(int col) {
+    int& onAscending = ascending[rows[col] + col];
+    int& onDescending = descending[rows[col] - col + dimension - 1];
+    if (--onAscending > 0) numCollisions--;
+    if (--onDescending > 0) numCollisions--;
+}
+
+/**
+ * Method: swapRows
+ * ----------------
+ * Trades the rows of the queens in the two specified columns, updating
+ * the diagonal counters and the collision count to match.
+ */
+void QueensMinConflicts::swapRows(int first, int second) {
+    removeQueen(first);
+    removeQueen(second);
+    swap(rows[first], rows[second]);
+    addQueen(first);
+    addQueen(second);
+}
+
+/**
+ * Method: randomColumn
+ * --------------------
+ * Returns a column chosen uniformly at random from [low, high].
+ */
+int QueensMinConflicts::randomColumn(int low, int high) {
+    return uniform_int_distribution<int>(low, high)(generator);
+}
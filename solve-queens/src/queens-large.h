@@ -0,0 +1,102 @@
+/**
+ * File: queens-large.h
+ * --------------------
+ * Exports the tools used to place queens on boards far too large for
+ * backtracking, which includes boards with millions of rows.  None of
+ * them relies on bitmasks, so there's no limit on the dimension beyond
+ * the memory needed to store a handful of integers per column.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * Function: constructQueens
+ * -------------------------
+ * Returns a solution to the N-Queens problem for the provided dimension,
+ * where solution[col] is the row of the queen in column col.  Boards of
+ * dimension 2 and 3, which have no solutions, produce an empty vector.
+ * The solution is built directly from a closed-form pattern of rows,
+ * without any search at all, in O(dimension) time.
+ */
+std::vector<int> constructQueens(int dimension);
+
+/**
+ * Function: isQueensSolution
+ * --------------------------
+ * Returns true if and only if no two of the queens described by rows
+ * (where rows[col] is the row of the queen in column col) attack one
+ * another.  Runs in O(rows.size()) time.
+ */
+bool isQueensSolution(const std::vector<int>& rows);
+
+/**
+ * Class: QueensMinConflicts
+ * -------------------------
+ * Searches for a solution using min-conflicts local search rather than
+ * backtracking.  The queens always occupy distinct rows, because the
+ * placement is kept as a permutation of the rows, and the number of queens
+ * on each diagonal is tracked by counters that are updated in O(1) time
+ * whenever two queens trade rows.  The search begins from a greedy random
+ * placement that is usually within a few dozen conflicts of a solution, and
+ * repeatedly swaps the row of a queen under attack with that of a random
+ * other queen whenever doing so reduces the number of attacks.
+ */
+class QueensMinConflicts {
+public:
+
+    /**
+     * Constructor: QueensMinConflicts
+     * -------------------------------
+     * Constructs a solver for a square board of the provided dimension.
+     * The seed determines the sequence of random choices, so equal seeds
+     * produce equal solutions.
+     */
+    QueensMinConflicts(int dimension, uint32_t seed = 1);
+
+    /**
+     * Method: solve
+     * -------------
+     * Searches for a solution, returning true if and only if one was found
+     * within the provided number of swaps attempted.  (Boards of dimension 2
+     * and 3 have no solutions, so solve gives up on them right away.)  If true
+     * is returned, getRows describes the solution.
+     */
+    bool solve(uint64_t maxSwaps = UINT64_MAX);
+
+    /**
+     * Method: getRows
+     * ---------------
+     * Returns the current placement, where rows[col] is the row of the queen
+     * in column col.
+     */
+    const std::vector<int>& getRows() const { return rows; }
+
+    /**
+     * Method: getSwapCount
+     * --------------------
+     * Returns the number of swaps attempted during the repair phase of the
+     * most recent call to solve.
+     */
+    uint64_t getSwapCount() const { return numSwaps; }
+
+private:
+    int dimension;
+    std::mt19937 generator;
+    std::vector<int> rows;
+    std::vector<int> ascending;  // ascending[row + col] counts queens on each / diagonal
+    std::vector<int> descending; // descending[row - col + dimension - 1] counts queens on each \ diagonal
+    uint64_t numCollisions;      // sum, over every occupied diagonal, of its queens beyond the first
+    uint64_t numSwaps;
+
+    void placeGreedily();
+    bool repair(uint64_t maxSwaps);
+    bool isAttacked(int col, int minimum) const;
+    void addQueen(int col);
+    void removeQueen(int col);
+    void swapRows(int first, int second);
+    int randomColumn(int low, int high);
+};
@@ -0,0 +1,77 @@
+/**
+ * File: queens-observers.h
+ * ------------------------
+ * Defines the observers that can stand in for a QueensDisplay when the
+ * search is run without animation.  The solvers are templated on the type
+ * of their observer, and any class with the four methods below (QueensDisplay
+ * included) will do.  Because the calls are resolved at compile time, the
+ * empty methods of NullQueensObserver compile away to nothing, and the
+ * search runs exactly as if it had never been observed at all.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Class: NullQueensObserver
+ * -------------------------
+ * Ignores everything the search reports.
+ */
+class NullQueensObserver {
+public:
+    void considerQueen(int, int) {}
+    void provisionallyPlaceQueen(int, int) {}
+    void permanentlyPlaceQueen(int, int) {}
+    void removeQueen(int, int) {}
+};
+
+/**
+ * Class: CountingQueensObserver
+ * -----------------------------
+ * Tallies everything the search reports, so that the size and shape of
+ * the search can be reported without animating it.
+ */
+class CountingQueensObserver {
+public:
+    CountingQueensObserver() : numConsidered(0), numPlaced(0), numKept(0), numRemoved(0) {}
+
+    void considerQueen(int, int) { numConsidered++; }
+    void provisionallyPlaceQueen(int, int) { numPlaced++; }
+    void permanentlyPlaceQueen(int, int) { numKept++; }
+    void removeQueen(int, int) { numRemoved++; }
+
+    uint64_t numConsidered; // cells examined
+    uint64_t numPlaced;     // queens provisionally placed (nodes of the search tree)
+    uint64_t numKept;       // queens that ended up in the solution
+    uint64_t numRemoved;    // queens taken back (backtracks)
+};
+
+/**
+ * Class: QueensSearchObserver
+ * ---------------------------
+ * Relays what a Backtracker (see backtracking.h) reports about a search
+ * whose variables are the columns and whose values are the rows to any of
+ * the observers above, or to a QueensDisplay.  The bitboard search only
+ * ever tries safe rows, so each row reported is considered and placed at
+ * once, and the rows under attack are never reported at all.  That's why
+ * the animated program in queens.cpp keeps its Grid<bool> search, which
+ * shows every row it rejects.
+ */
+template <typename Observer>
+class QueensSearchObserver {
+public:
+    QueensSearchObserver(Observer& observer) : observer(observer) {}
+
+    void enterNode() {}
+    void applyValue(int col, int row) {
+        observer.considerQueen(row, col);
+        observer.provisionallyPlaceQueen(row, col);
+    }
+    void retractValue(int col, int row) { observer.removeQueen(row, col); }
+    void keepValue(int col, int row) { observer.permanentlyPlaceQueen(row, col); }
+    void recordSolution() {}
+
+private:
+    Observer& observer;
+};
@@ -0,0 +1,188 @@
+/**
+ * File: queens-parallel.cpp
+ * -------------------------
+ * Presents the implementation of the QueensParallelSolver class.  The
+ * prefixes that count splits the search into are dealt round-robin into
+ * one queue per thread.  Each thread works from the back of its own queue
+ * and, once that's empty, steals from the front of the others, so threads
+ * saddled with unusually large subtrees shed the rest of their work to
+ * idle ones.  Prefixes never beget new tasks, so once every queue is
+ * empty, the search is over.
+ */
+
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "parallel-backtracking.h"
+#include "queens-parallel.h"
+#include "queens-bitboard.h"
+#include "queens-counter.h"
+using namespace std;
+
+/* Constants */
+static const int kTasksPerThread = 64; // enough that stealing smooths out uneven subtrees
+
+QueensParallelSolver::QueensParallelSolver(int dimension, int numThreads) :
+    dimension(dimension),
+    numThreads(numThreads > 0 ? numThreads : max(1, (int) thread::hardware_concurrency())),
+    isDeterministic(false),
+    queens(dimension, -1),
+    numTotal(0),
+    numUnique(0),
+    numNodes(0) {}
+
+/**
+ * Method: splitSearch
+ * -------------------
+ * Returns every legal placement of queens in the first k columns, where k
+ * is the smallest number of columns that produces kTasksPerThread tasks per
+ * thread.  The first queen is confined to the lower half of the first column,
+ * which is all QueensCounter needs.
+ */
+vector<vector<int> > QueensParallelSolver::splitSearch() const {
+    vector<vector<int> > prefixes;
+    for (int row = 0; row < (dimension + 1) / 2; row++) {
+        prefixes.push_back(vector<int>(1, row));
+    }
+
+    size_t numTasks = (size_t) numThreads * kTasksPerThread;
+    for (int col = 1; col < dimension - 1 && prefixes.size() < numTasks; col++) {
+        vector<vector<int> > extended;
+        for (const vector<int>& prefix: prefixes) {
+            for (int row = 0; row < dimension; row++) {
+                bool safe = true;
+                for (int c = 0; c < col && safe; c++) {
+                    safe = prefix[c] != row && abs(prefix[c] - row) != col - c;
+                }
+                if (!safe) continue;
+                extended.push_back(prefix);
+                extended.back().push_back(row);
+            }
+        }
+        prefixes.swap(extended);
+    }
+    return prefixes;
+}
+
+/**
+ * Type: TaskQueue
+ * ---------------
+ * One thread's share of the prefixes, guarded by its own lock so that
+ * the owner and thieves rarely contend with one another.
+ */
+struct TaskQueue {
+    mutex lock;
+    deque<const vector<int> *> tasks;
+};
+
+/**
+ * Function: takeTask
+ * ------------------
+ * Surfaces the next prefix that the specified thread should search,
+ * taking from the back of its own queue if possible and stealing from
+ * the front of another thread's queue otherwise.  Returns NULL once
+ * there's no work left anywhere.
+ */
+static const vector<int> *takeTask(vector<TaskQueue>& queues, int self) {
+    {
+        lock_guard<mutex> guard(queues[self].lock);
+        if (!queues[self].tasks.empty()) {
+            const vector<int> *task = queues[self].tasks.back();
+            queues[self].tasks.pop_back();
+            return task;
+        }
+    }
+
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        TaskQueue& victim = queues[(self + offset) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            const vector<int> *task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return task;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Type: TaskSource
+ * ----------------
+ * Describes the function each thread calls to get its next prefix, which
+ * returns NULL once there are none left.
+ */
+typedef function<const vector<int> *()> TaskSource;
+
+/**
+ * Function: runTasks
+ * ------------------
+ * Deals the prefixes out to numThreads queues and runs numThreads threads,
+ * each executing body with a TaskSource that stops producing prefixes once
+ * every queue is empty.  Each body typically keeps its own solver and
+ * totals on its own stack, so that threads never write to memory shared
+ * with one another until they are done.
+ */
+static void runTasks(const vector<vector<int> >& prefixes, int numThreads,
+                     const function<void(const TaskSource& nextTask)>& body) {
+    vector<TaskQueue> queues(numThreads);
+    for (size_t i = 0; i < prefixes.size(); i++) {
+        queues[i % numThreads].tasks.push_front(&prefixes[i]);
+    }
+
+    vector<thread> threads;
+    for (int self = 0; self < numThreads; self++) {
+        threads.push_back(thread([&queues, &body, self]() {
+            TaskSource nextTask = [&queues, self]() -> const vector<int> * {
+                return takeTask(queues, self);
+            };
+            body(nextTask);
+        }));
+    }
+    for (thread& t: threads) t.join();
+}
+
+/**
+ * Implementation notes: solve
+ * ---------------------------
+ * Each thread gets its own solver, and a problem that starts from that
+ * solver's empty board.  The solution is left in the first solver.
+ */
+bool QueensParallelSolver::solve() {
+    vector<QueensBitboard> solvers(numThreads, QueensBitboard(dimension));
+    vector<QueensBitboard::Problem> problems;
+    vector<QueensBitboard::Problem *> threadProblems;
+    problems.reserve(numThreads);
+    for (QueensBitboard& solver: solvers) {
+        problems.push_back(QueensBitboard::Problem(solver, 0, 0, 0, 0));
+        threadProblems.push_back(&problems.back());
+    }
+
+    ParallelBacktracker<QueensBitboard::Problem> search(threadProblems);
+    search.setDeterministic(isDeterministic);
+    bool found = search.findFirst();
+    numNodes = search.getNodeCount();
+    if (found) {
+        for (int col = 0; col < dimension; col++) {
+            queens[col] = solvers[0].getRow(col);
+        }
+    }
+    return found;
+}
+
+void QueensParallelSolver::count() {
+    mutex resultsLock;
+    numTotal = numUnique = numNodes = 0;
+    runTasks(splitSearch(), numThreads, [&](const TaskSource& nextTask) {
+        QueensCounter counter(dimension);
+        const vector<int> *prefix;
+        while ((prefix = nextTask()) != NULL) {
+            counter.countFrom(*prefix);
+        }
+        lock_guard<mutex> guard(resultsLock);
+        numTotal += counter.getTotalCount();
+        numUnique += counter.getUniqueCount();
+        numNodes += counter.getNodeCount();
+    });
+}
@@ -0,0 +1,118 @@
+/**
+ * File: queens-parallel.h
+ * -----------------------
+ * Defines the QueensParallelSolver class, which spreads the N-Queens search
+ * across every core.  Finding a solution is left to a ParallelBacktracker
+ * (see parallel-backtracking.h) driving one bitboard solver per thread.
+ * For counting, the tree is split by enumerating every legal placement of
+ * queens in the first few columns, and each such prefix becomes a task
+ * that one thread counts below.  Tasks are dealt out to per-thread queues,
+ * and threads that run out of work steal from the others.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Class: QueensParallelSolver
+ * ---------------------------
+ * Offers a multi-threaded take on QueensBitboard::solve (find the first
+ * solution, with the remaining threads cancelled as soon as one is found)
+ * and QueensCounter::count (count every solution, with each thread keeping
+ * its own totals until the end).
+ */
+class QueensParallelSolver {
+public:
+
+    /**
+     * Constructor: QueensParallelSolver
+     * ---------------------------------
+     * Constructs a solver for a square board of the provided dimension.
+     * If numThreads is 0, one thread is used per hardware thread.
+     */
+    QueensParallelSolver(int dimension, int numThreads = 0);
+
+    /**
+     * Method: setDeterministic
+     * ------------------------
+     * Chooses whether solve finds the same solution QueensBitboard::solve
+     * would, however the threads happen to run.  It doesn't by default,
+     * since the first solution any thread finds is usually found sooner.
+     */
+    void setDeterministic(bool isDeterministic) { this->isDeterministic = isDeterministic; }
+
+    /**
+     * Method: solve
+     * -------------
+     * Searches for a solution, returning true if and only if one was found.
+     * If true is returned, getRow reports where each queen was placed.
+     */
+    bool solve();
+
+    /**
+     * Method: count
+     * -------------
+     * Counts every solution, after which getTotalCount and getUniqueCount
+     * report the results.
+     */
+    void count();
+
+    /**
+     * Method: getRow
+     * --------------
+     * Returns the row of the queen placed in the specified column by the
+     * most recent successful call to solve.
+     */
+    int getRow(int col) const { return queens[col]; }
+
+    /**
+     * Method: getDimension
+     * --------------------
+     * Returns the number of rows (and columns) on the board.
+     */
+    int getDimension() const { return dimension; }
+
+    /**
+     * Method: getNumThreads
+     * ---------------------
+     * Returns the number of threads that share the search.
+     */
+    int getNumThreads() const { return numThreads; }
+
+    /**
+     * Method: getTotalCount
+     * ---------------------
+     * Returns the number of distinct solutions found by the most recent
+     * call to count.
+     */
+    uint64_t getTotalCount() const { return numTotal; }
+
+    /**
+     * Method: getUniqueCount
+     * ----------------------
+     * Returns the number of solutions found by the most recent call to count
+     * that are unique up to rotation and reflection.
+     */
+    uint64_t getUniqueCount() const { return numUnique; }
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of queens placed, across all threads, by the most
+     * recent call to solve or count.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+private:
+    int dimension;
+    int numThreads;
+    bool isDeterministic;
+    std::vector<int> queens;
+    uint64_t numTotal;
+    uint64_t numUnique;
+    uint64_t numNodes;
+
+    std::vector<std::vector<int> > splitSearch() const;
+};
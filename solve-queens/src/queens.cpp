@@ -5,14 +5,19 @@
  * used to solve the N-Queens problem.
  */
 
+#include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <string>
 #include "console.h"
 #include "simpio.h"
+#include "queens-completion.h"
+#include "queens-large.h"
+#include "queens-parallel.h"
 #include "queens-display.h"
 #include "queens-constants.h"
 #include "grid.h"
-#include "queens-constants.h"
+#include "stopwatch.h"
 using namespace std;
 
 /**
@@ -26,7 +31,7 @@ static int getIntegerInRange(int low, int high) {
     string prompt = "Please enter an integer between " + integerToString(low) + " and " + integerToString(high) + " [or 0 to quit]";
     while (true) {
         int response = getInteger(prompt);
-        if (response == 0 || (response >= low) /* && response <= high) */) return response;
+        if (response == 0 || (response >= low && response <= high)) return response;
         cout << "Response out of range." << endl;
     }
 }
@@ -70,7 +75,8 @@ static bool isSafe(const Grid<bool>& board, int row, int col) {
  * can be placed in column col and beyond to silve the N-Queens
  * problem.
  */
-static bool solve(QueensDisplay& display, Grid<bool>& board, int col) {
+template <typename Display>
+static bool solve(Display& display, Grid<bool>& board, int col) {
     if (col == board.numCols()) return true;
     for (int rowToTry = 0; rowToTry < board.numRows(); rowToTry++) {
         display.considerQueen(rowToTry, col);
@@ -97,21 +103,174 @@ static bool solve(QueensDisplay& display, Grid<bool>& board, int col) {
  * the discovery of the solution using the second form of solve implemented
  * above.
  */
-static void solve(QueensDisplay& display, Grid<bool>& board) {
+template <typename Display>
+static void solve(Display& display, Grid<bool>& board) {
     solve(display, board, 0);
 }
 
+/**
+ * Function: printSolution
+ * -----------------------
+ * Prints the board found by the provided solver to the console, one line
+ * per row, using Q for a queen and . for an empty cell.
+ */
+template <typename Solver>
+static void printSolution(const Solver& solver) {
+    for (int row = solver.getDimension() - 1; row >= 0; row--) {
+        string line;
+        for (int col = 0; col < solver.getDimension(); col++) {
+            line += solver.getRow(col) == row ? 'Q' : '.';
+        }
+        cout << line << endl;
+    }
+}
+
+/**
+ * Function: printSolution
+ * -----------------------
+ * Prints the placement in rows, where rows[col] is the row of the queen in
+ * column col, just as the other version prints a solver's.
+ */
+static void printSolution(const vector<int>& rows) {
+    for (int row = rows.size() - 1; row >= 0; row--) {
+        string line;
+        for (int col = 0; col < (int) rows.size(); col++) {
+            line += rows[col] == row ? 'Q' : '.';
+        }
+        cout << line << endl;
+    }
+}
+
+/**
+ * Function: solveWithoutAnimation
+ * -------------------------------
+ * Solves the N-Queens problem for boards too large to animate, relying
+ * on the multi-threaded bitboard solver and printing its solution and
+ * search statistics to the console.
+ */
+static void solveWithoutAnimation(int dimension) {
+    QueensParallelSolver solver(dimension);
+    Stopwatch stopwatch;
+    bool solved = solver.solve();
+    double seconds = stopwatch.getElapsedSeconds();
+    if (solved) {
+        printSolution(solver);
+    } else {
+        cout << "There is no way to place " << dimension << " queens." << endl;
+    }
+    cout << solver.getNodeCount() << " nodes in " << seconds << " seconds";
+    if (seconds > 0) cout << " (" << uint64_t(solver.getNodeCount() / seconds) << " nodes/sec)";
+    cout << endl;
+}
+
+/**
+ * Function: solveByConstruction
+ * -----------------------------
+ * Places the queens on boards too large to search in any reasonable time,
+ * building the solution from the closed-form pattern in queens-large.h
+ * rather than searching for one.
+ */
+static void solveByConstruction(int dimension) {
+    Stopwatch stopwatch;
+    vector<int> rows = constructQueens(dimension);
+    double seconds = stopwatch.getElapsedSeconds();
+    printSolution(rows);
+    cout << "Constructed without searching in " << seconds << " seconds" << endl;
+}
+
+/**
+ * Function: countSolutions
+ * ------------------------
+ * Counts every solution to the N-Queens problem for the provided dimension,
+ * printing the total number of solutions, the number that are unique up to
+ * rotation and reflection, and the size of the search to the console.
+ */
+static void countSolutions(int dimension) {
+    QueensParallelSolver counter(dimension);
+    Stopwatch stopwatch;
+    counter.count();
+    double seconds = stopwatch.getElapsedSeconds();
+    cout << dimension << " queens: " << counter.getTotalCount() << " solutions, "
+         << counter.getUniqueCount() << " unique up to symmetry" << endl;
+    cout << counter.getNodeCount() << " nodes in " << seconds << " seconds using "
+         << counter.getNumThreads() << " threads" << endl;
+}
+
+/**
+ * Function: completePlacement
+ * ---------------------------
+ * Prompts for a file holding a partial placement (see readPartialPlacement)
+ * and extends it to a full solution, or proves that it can't be extended.
+ * Boards small enough to animate are searched on the display, with the
+ * queens placed in advance appearing first; larger ones are printed.
+ */
+static void completePlacement(QueensDisplay& display) {
+    string filename = getLine("Placement file: ");
+    ifstream in(filename.c_str());
+    int dimension;
+    vector<pair<int, int> > queens;
+    if (!in || !readPartialPlacement(in, dimension, queens)) {
+        cout << filename << " doesn't hold a partial placement." << endl;
+        return;
+    }
+
+    QueensCompletion solver(dimension);
+    for (const pair<int, int>& queen: queens) {
+        if (!solver.placeQueen(queen.first, queen.second)) {
+            cout << filename << " places two queens in column " << queen.second << "." << endl;
+            return;
+        }
+    }
+    if (dimension >= kMinBoardDimension && dimension <= kMaxBoardDimension) {
+        display.setDimension(dimension);
+        if (!solver.solve(display)) cout << "The placement can't be extended." << endl;
+        return;
+    }
+
+    Stopwatch stopwatch;
+    bool solved = solver.solve();
+    double seconds = stopwatch.getElapsedSeconds();
+    if (solved) {
+        printSolution(solver);
+    } else {
+        cout << "The placement can't be extended." << endl;
+    }
+    cout << solver.getNodeCount() << " nodes and " << solver.getRestartCount()
+         << " restarts in " << seconds << " seconds" << endl;
+}
+
 /**
  * Function: main
  * --------------
  * Defines the entry point of the entire program, which allows the
- * user to discover solutions to the N-Queens problem.
+ * user to discover solutions to the N-Queens problem.  Boards up to
+ * kMaxBoardDimension are animated, larger ones up to kMaxSearchDimension
+ * are searched silently, and larger ones still are built by construction,
+ * since the search wouldn't finish.  The user can instead elect to count
+ * every solution, on boards up to kMaxCountDimension, or to complete a
+ * partial placement read from a file.
  */
 int main() {
     QueensDisplay display;
     while (true) {
-        int dimension = getIntegerInRange(kMinBoardDimension, kMaxBoardDimension);
+        if (getYesOrNo("Complete a placement from a file? ")) {
+            completePlacement(display);
+            continue;
+        }
+        int dimension = getIntegerInRange(kMinBoardDimension, kMaxBitboardDimension);
         if (dimension == 0) break;
+        if (dimension <= kMaxCountDimension && getYesOrNo("Count every solution? ")) {
+            countSolutions(dimension);
+            continue;
+        }
+        if (dimension > kMaxSearchDimension) {
+            solveByConstruction(dimension);
+            continue;
+        }
+        if (dimension > kMaxBoardDimension) {
+            solveWithoutAnimation(dimension);
+            continue;
+        }
         Grid<bool> board(dimension, dimension);
         display.setDimension(dimension);
         solve(display, board);
@@ -0,0 +1,627 @@
+/**
+ * File: sudoku-headless.cpp
+ * -------------------------
+ * Presents a command-line program that solves SuDoKu puzzles without any
+ * animation.  Usage:
+ *
+ *     sudoku-headless [-order n] [-stats] [-dlx | -cdcl | -strategy name] [-rules file] [-out stream] [file ...]
+ *     sudoku-headless [-order n] [-stats] -threads n [-deterministic] [-strategy name] [-rules file] [file ...]
+ *     sudoku-headless [-order n] [-stats] [-rules file] -count limit [file ...]
+ *     sudoku-headless [-order n] [-seed s] [-rules file] -compare [file ...]
+ *     sudoku-headless -batch [-threads n] [-stats] [-dlx | -simd] [file ...]
+ *     sudoku-headless -read stream
+ *     sudoku-headless -generate n [-seed s] [-threads n] [-stats]
+ *
+ * Puzzles are read one per line, as 81 characters listed row by row with
+ * '0' or '.' for empty cells, from the named files or from standard input.
+ * Each solution is printed on its own line in the same format.  -order
+ * solves puzzles whose blocks are n x n rather than 3 x 3, for n from 2
+ * to 6, so 16 x 16 puzzles have order 4.  Their cells are given with the
+ * symbols 1-9 and then A-Z, or as numbers separated by spaces (see
+ * sudoku-board.h).  -stats reports how much work the searches did once
+ * every puzzle is solved.
+ * -dlx solves the puzzles as exact cover problems using dancing links (see
+ * sudoku-exact-cover.h) instead of with the backtracking search, and -cdcl
+ * solves them with conflict-driven clause learning (see sudoku-cdcl.h),
+ * which is what the hardest 16 x 16 and 25 x 25 puzzles call for.
+ * -strategy has the backtracking search order its choices one of the ways
+ * listed in sudoku-strategy.h: first-empty, mrv (the default), mrv-degree,
+ * mrv-scan, mrv-random, or lcv.  -compare solves every puzzle with each of
+ * them in turn instead of printing solutions, and prints tables of the
+ * nodes each search took and the time it spent, so the best ordering for a
+ * corpus can be picked out; -seed seeds the random ordering.
+ * -rules solves the puzzles by the rules in the named file (see
+ * sudoku-rules.h) rather than the classic ones, so jigsaw, X, windoku, and
+ * killer puzzles can be solved with the backtracking search, and their
+ * solutions counted or their orderings compared.
+ * -count prints the number of solutions each puzzle has instead of a
+ * solution, giving up once limit of them have been found, in which case the
+ * count is followed by a '+'.  -count 2 is enough to tell which puzzles have
+ * a unique solution.
+ * -threads, without -batch or -generate, solves each puzzle on n threads
+ * that share its search through a ParallelBacktracker (see
+ * parallel-backtracking.h), which pays off on the hard puzzles of the
+ * larger orders.  A puzzle with several solutions may then get a different
+ * one from run to run, unless -deterministic is also given, in which case
+ * it gets the one the sequential search finds.  -deterministic can't be
+ * combined with -strategy mrv-random, whose choices depend on every
+ * random number drawn before them, not just on the board.
+ * -out writes the solutions to a solution stream (see solution-stream.h)
+ * instead of printing them, and -read prints the solutions in such a stream.
+ * -batch solves the puzzles on every hardware thread (or on -threads of
+ * them) with a SuDoKuBatchSolver, which memory-maps the named files and
+ * still prints the solutions in order; with -stats, it reports throughput
+ * rather than the size of the searches.  -batch only handles 9 x 9 puzzles.
+ * -simd, which requires -batch, solves them with the vectorized kernel in
+ * sudoku-kernel.h.
+ * -generate prints n new 9 x 9 puzzles, each with a unique solution, along
+ * with their difficulty, number of clues, and number of search nodes (see
+ * sudoku-generator.h).  They're generated on every hardware thread (or on
+ * -threads of them), and the same -seed (1 by default) always produces the
+ * same puzzles.
+ * If the program is built with CONFIG+=sudoku_stats, -stats also prints
+ * the detailed counters the search keeps about itself (see sudoku-stats.h).
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "solution-stream.h"
+#include "sudoku-batch.h"
+#include "sudoku-board.h"
+#include "sudoku-cdcl.h"
+#include "sudoku-exact-cover.h"
+#include "sudoku-generator.h"
+#include "sudoku-observers.h"
+#include "sudoku-rules.h"
+#include "sudoku-solver.h"
+#include "sudoku-strategy.h"
+#include "stopwatch.h"
+using namespace std;
+
+/**
+ * Function: reportSolution
+ * ------------------------
+ * Prints the solved board, or appends it to the solution stream if
+ * there is one.
+ */
+template <int Order>
+static void reportSolution(const BasicSuDoKuBoard<Order>& board, SolutionStreamWriter *out) {
+    if (out == NULL) {
+        cout << board.toString() << endl;
+        return;
+    }
+
+    const int kDimension = Order * Order;
+    int digits[kDimension * kDimension];
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            digits[row * kDimension + col] = board[row][col];
+        }
+    }
+    out->write(digits);
+}
+
+/**
+ * Function: solvePuzzles
+ * ----------------------
+ * Solves every puzzle in the provided stream, printing one line per puzzle
+ * and reporting each step of each search to the provided observer.  The
+ * puzzles are handed to the exact cover solver or the clause learning
+ * solver if there is one, and are of whatever order it is built for either
+ * way.  Otherwise the backtracking search follows the provided strategy
+ * and rules, and runs on numThreads threads if numThreads isn't 0, in which
+ * case the observer hears nothing.
+ */
+template <typename Observer, int Order>
+static void solvePuzzles(istream& in, Observer& observer, BasicSuDoKuExactCover<Order> *dlx,
+                         BasicSuDoKuCDCL<Order> *cdcl, SuDoKuStrategy& strategy, const BasicSuDoKuRules<Order>& rules,
+                         int numThreads, bool isDeterministic, SolutionStreamWriter *out, int& numPuzzles) {
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty()) continue;
+        BasicSuDoKuBoard<Order> board;
+        if (!board.load(line)) {
+            cout << "invalid" << endl;
+        } else if (dlx != NULL ? dlx->solve(observer, board) :
+                   cdcl != NULL ? cdcl->solve(observer, board) :
+                   numThreads != 0 ? solveInParallel(board, numThreads, strategy, rules, isDeterministic) :
+                   solve(observer, board, strategy, rules)) {
+            reportSolution(board, out);
+        } else {
+            cout << "unsolvable" << endl;
+        }
+        numPuzzles++;
+    }
+}
+
+/**
+ * Function: countPuzzles
+ * ----------------------
+ * Counts the solutions to every puzzle in the provided stream, printing one
+ * line per puzzle and reporting each step of each search to the provided
+ * observer.
+ */
+template <typename Observer, int Order>
+static void countPuzzles(istream& in, Observer& observer, const BasicSuDoKuRules<Order>& rules, uint64_t limit,
+                         int& numPuzzles) {
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (line.empty()) continue;
+        BasicSuDoKuBoard<Order> board;
+        if (!board.load(line)) {
+            cout << "invalid" << endl;
+        } else {
+            uint64_t numSolutions = countSolutions(observer, board, limit, rules);
+            cout << numSolutions << (numSolutions == limit ? "+" : "") << endl;
+        }
+        numPuzzles++;
+    }
+}
+
+/**
+ * Function: solveAll
+ * ------------------
+ * Solves the puzzles in each of the named files, or in standard input
+ * if no files are named, or counts their solutions if countLimit isn't 0.
+ * Returns false if some file can't be opened.
+ */
+template <typename Observer, int Order>
+static bool solveAll(const vector<string>& filenames, Observer& observer, BasicSuDoKuExactCover<Order> *dlx,
+                     BasicSuDoKuCDCL<Order> *cdcl, SuDoKuStrategy& strategy, const BasicSuDoKuRules<Order>& rules,
+                     int numThreads, bool isDeterministic, SolutionStreamWriter *out, uint64_t countLimit,
+                     int& numPuzzles) {
+    if (filenames.empty()) {
+        if (countLimit != 0) countPuzzles(cin, observer, rules, countLimit, numPuzzles);
+        else solvePuzzles(cin, observer, dlx, cdcl, strategy, rules, numThreads, isDeterministic, out, numPuzzles);
+        return true;
+    }
+
+    for (const string& filename: filenames) {
+        ifstream in(filename.c_str());
+        if (!in) {
+            cerr << "Could not open " << filename << endl;
+            return false;
+        }
+        if (countLimit != 0) countPuzzles(in, observer, rules, countLimit, numPuzzles);
+        else solvePuzzles(in, observer, dlx, cdcl, strategy, rules, numThreads, isDeterministic, out, numPuzzles);
+    }
+    return true;
+}
+
+/**
+ * Function: loadRules
+ * -------------------
+ * Adds the rules in the named file, if one is named, to the classic ones,
+ * returning false after saying why if the file can't be opened or read.
+ */
+template <int Order>
+static bool loadRules(const string& filename, BasicSuDoKuRules<Order>& rules) {
+    if (filename.empty()) return true;
+    ifstream in(filename.c_str());
+    if (!in) {
+        cerr << "Could not open " << filename << endl;
+        return false;
+    }
+    if (!rules.load(in)) {
+        cerr << "Could not read the rules in " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function: readPuzzles
+ * ---------------------
+ * Appends every valid puzzle in the stream to puzzles, skipping the lines
+ * that aren't boards of the provided order.
+ */
+template <int Order>
+static void readPuzzles(istream& in, vector<BasicSuDoKuBoard<Order> >& puzzles) {
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        BasicSuDoKuBoard<Order> board;
+        if (!line.empty() && board.load(line)) puzzles.push_back(board);
+    }
+}
+
+/**
+ * Function: printTable
+ * --------------------
+ * Prints one row per ordering with the total, mean, median, and largest of
+ * the provided per-puzzle measurements, which are sorted in the process.
+ */
+static void printTable(const string& title, vector<vector<double> >& measurements, int precision) {
+    cout << left << setw(14) << title << right << setw(16) << "total" << setw(14) << "mean"
+         << setw(14) << "median" << setw(14) << "max" << endl;
+    cout << fixed << setprecision(precision);
+    for (int ordering = 0; ordering < kNumOrderings; ordering++) {
+        vector<double>& values = measurements[ordering];
+        sort(values.begin(), values.end());
+        double total = 0;
+        for (double value: values) {
+            total += value;
+        }
+        cout << left << setw(14) << getOrderingName(SuDoKuOrdering(ordering)) << right << setw(16) << total
+             << setw(14) << (values.empty() ? 0 : total / values.size())
+             << setw(14) << (values.empty() ? 0 : values[values.size() / 2])
+             << setw(14) << (values.empty() ? 0 : values.back()) << endl;
+    }
+    cout.unsetf(ios::floatfield);
+}
+
+/**
+ * Function: compareStrategies
+ * ---------------------------
+ * Solves every puzzle in the named files, or in standard input if no files
+ * are named, once with each ordering, and prints a table of the nodes each
+ * search took and one of the seconds it took, along with how many puzzles
+ * each ordering solved.  The puzzles follow the rules in the file named
+ * rulesFilename, if there is one.  Returns false if some file can't be
+ * opened.
+ */
+template <int Order>
+static bool compareStrategies(const vector<string>& filenames, const string& rulesFilename, uint64_t seed) {
+    BasicSuDoKuRules<Order> rules;
+    if (!loadRules(rulesFilename, rules)) return false;
+    vector<BasicSuDoKuBoard<Order> > puzzles;
+    if (filenames.empty()) readPuzzles(cin, puzzles);
+    for (const string& filename: filenames) {
+        ifstream in(filename.c_str());
+        if (!in) {
+            cerr << "Could not open " << filename << endl;
+            return false;
+        }
+        readPuzzles(in, puzzles);
+    }
+
+    vector<vector<double> > nodes(kNumOrderings), seconds(kNumOrderings);
+    cout << puzzles.size() << " puzzles:";
+    for (int ordering = 0; ordering < kNumOrderings; ordering++) {
+        SuDoKuStrategy strategy(SuDoKuOrdering(ordering), seed);
+        NullSuDoKuObserver observer;
+        int numSolved = 0;
+        for (const BasicSuDoKuBoard<Order>& puzzle: puzzles) {
+            BasicSuDoKuBoard<Order> board = puzzle;
+            strategy.resetChoiceCount();
+            Stopwatch stopwatch;
+            if (solve(observer, board, strategy, rules)) numSolved++;
+            seconds[ordering].push_back(stopwatch.getElapsedSeconds());
+            nodes[ordering].push_back(strategy.getChoiceCount());
+        }
+        cout << (ordering == 0 ? " " : ", ") << getOrderingName(SuDoKuOrdering(ordering)) << " solved " << numSolved;
+    }
+    cout << endl << endl;
+    printTable("nodes", nodes, 0);
+    cout << endl;
+    printTable("seconds", seconds, 6);
+    return true;
+}
+
+/**
+ * Function: printSolutions
+ * ------------------------
+ * Prints every solution in the stream, one per line, as boards of the
+ * provided order.  Returns false if some record is missing.
+ */
+template <int Order>
+static bool printSolutions(SolutionStreamReader& in) {
+    const int kDimension = Order * Order;
+    BasicSuDoKuBoard<Order> board;
+    vector<int> digits;
+    for (uint64_t record = 0; record < in.getRecordCount(); record++) {
+        if (!in.read(record, digits)) {
+            cout.flush();
+            return false;
+        }
+        for (int cell = 0; cell < kDimension * kDimension; cell++) {
+            board[cell / kDimension][cell % kDimension] = digits[cell];
+        }
+        cout << board.toString() << '\n';
+    }
+    cout.flush();
+    return true;
+}
+
+/**
+ * Function: printStream
+ * ---------------------
+ * Prints every solution in the named solution stream, one per line, working
+ * out the order of the boards from the number of values in each solution.
+ * Returns false if the file isn't a stream of SuDoKu solutions, or is
+ * missing some of its records.
+ */
+static bool printStream(const string& filename) {
+    SolutionStreamReader in(filename);
+    int order = 0;
+    if (in.isOpen() && in.getKind() == kSuDoKuSolutions) {
+        for (int candidate = kMinBoardOrder; candidate <= kMaxBoardOrder; candidate++) {
+            if (in.getValuesPerRecord() == candidate * candidate * candidate * candidate) order = candidate;
+        }
+    }
+
+    bool isComplete = false;
+    switch (order) {
+        case 2: isComplete = printSolutions<2>(in); break;
+        case 3: isComplete = printSolutions<3>(in); break;
+        case 4: isComplete = printSolutions<4>(in); break;
+        case 5: isComplete = printSolutions<5>(in); break;
+        case 6: isComplete = printSolutions<6>(in); break;
+        default:
+            cerr << filename << " is not a stream of SuDoKu solutions" << endl;
+            return false;
+    }
+    if (!isComplete) cerr << filename << " is missing some of its records" << endl;
+    return isComplete;
+}
+
+/**
+ * Function: printSearchStats
+ * --------------------------
+ * Prints the counters published by every thread that searched, and by
+ * this one, provided they were compiled in.
+ */
+static void printSearchStats() {
+    if (!kSuDoKuStatsEnabled) return;
+    publishSuDoKuStats();
+    getPublishedSuDoKuStats().print(cerr);
+}
+
+/**
+ * Function: solveInBatches
+ * ------------------------
+ * Solves the puzzles in each of the named files, or in standard input if
+ * no files are named, using a SuDoKuBatchSolver.  Returns false if some
+ * file can't be opened.
+ */
+static bool solveInBatches(const vector<string>& filenames, int numThreads, SuDoKuBatchMethod method,
+                           bool withStats) {
+    SuDoKuBatchSolver solver(numThreads, method);
+    Stopwatch stopwatch;
+    bool succeeded = true;
+    if (filenames.empty()) {
+        string text((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+        solver.solve(text.data(), text.size(), cout);
+    }
+    for (const string& filename: filenames) {
+        if (!solver.solveFile(filename, cout)) {
+            cerr << "Could not open " << filename << endl;
+            succeeded = false;
+            break;
+        }
+    }
+
+    if (withStats) {
+        double seconds = stopwatch.getElapsedSeconds();
+        cerr << solver.getPuzzleCount() << " puzzles: " << solver.getSolvedCount() << " solved, "
+             << seconds << " seconds, " << solver.getNumThreads() << " threads";
+        if (seconds > 0) cerr << " (" << (long long) (solver.getPuzzleCount() / seconds) << " puzzles/sec)";
+        cerr << endl;
+        printSearchStats();
+    }
+    return succeeded;
+}
+
+/**
+ * Function: generateAll
+ * ---------------------
+ * Generates the puzzles and prints them, along with how quickly they were
+ * generated if withStats is true.
+ */
+static void generateAll(uint64_t numPuzzles, uint64_t seed, int numThreads, bool withStats) {
+    Stopwatch stopwatch;
+    generatePuzzles(numPuzzles, seed, numThreads, cout);
+    if (withStats) {
+        double seconds = stopwatch.getElapsedSeconds();
+        cerr << numPuzzles << " puzzles generated in " << seconds << " seconds";
+        if (seconds > 0) cerr << " (" << (long long) (numPuzzles / seconds) << " puzzles/sec)";
+        cerr << endl;
+        printSearchStats();
+    }
+}
+
+/**
+ * Function: solveWithOrder
+ * ------------------------
+ * Solves the puzzles in each of the named files, or in standard input if
+ * no files are named, as boards of the provided order, and returns the
+ * program's exit status.  If countLimit isn't 0, the solutions to each
+ * puzzle are counted, up to that limit, instead.  The puzzles follow the
+ * rules in the file named rulesFilename, if there is one, and are each
+ * solved on numThreads threads if numThreads isn't 0.  The searches are
+ * only observed when withStats is true, so that they otherwise run at full
+ * speed.
+ */
+template <int Order>
+static int solveWithOrder(const vector<string>& filenames, bool withStats, bool withDancingLinks,
+                          bool withClauseLearning, SuDoKuOrdering ordering, const string& rulesFilename,
+                          int numThreads, bool isDeterministic, const string& outFilename, uint64_t countLimit) {
+    const int kDimension = Order * Order;
+    BasicSuDoKuRules<Order> rules;
+    if (!loadRules(rulesFilename, rules)) return 1;
+
+    SolutionStreamWriter *out = NULL;
+    if (!outFilename.empty()) {
+        out = new SolutionStreamWriter(outFilename, kSuDoKuSolutions, kDimension * kDimension,
+                                       bitsNeededFor(kDimension));
+        if (!out->isOpen()) {
+            cerr << "Could not create " << outFilename << endl;
+            delete out;
+            return 1;
+        }
+    }
+
+    BasicSuDoKuExactCover<Order> *dlx = withDancingLinks ? new BasicSuDoKuExactCover<Order>() : NULL;
+    BasicSuDoKuCDCL<Order> *cdcl = withClauseLearning ? new BasicSuDoKuCDCL<Order>() : NULL;
+    SuDoKuStrategy strategy(ordering);
+    int numPuzzles = 0;
+    bool succeeded;
+    Stopwatch stopwatch;
+    if (!withStats) {
+        NullSuDoKuObserver observer;
+        succeeded = solveAll(filenames, observer, dlx, cdcl, strategy, rules, numThreads, isDeterministic, out,
+                             countLimit, numPuzzles);
+    } else {
+        CountingSuDoKuObserver observer;
+        succeeded = solveAll(filenames, observer, dlx, cdcl, strategy, rules, numThreads, isDeterministic, out,
+                             countLimit, numPuzzles);
+        double seconds = stopwatch.getElapsedSeconds();
+        cerr << numPuzzles << " puzzles: ";
+        if (numThreads != 0) cerr << seconds << " seconds, " << numThreads << " threads" << endl;
+        else cerr << observer.numPlaced << " placed, " << observer.numLifted << " lifted, " << seconds << " seconds"
+                  << endl;
+        printSearchStats();
+    }
+
+    delete dlx;
+    delete cdcl;
+
+    if (out != NULL) {
+        if (!out->close()) {
+            cerr << "Could not write " << outFilename << endl;
+            succeeded = false;
+        }
+        delete out;
+    }
+    return succeeded ? 0 : 1;
+}
+
+/**
+ * Function: main
+ * --------------
+ * Defines the entry point of the program, which hands the puzzles to the
+ * search specialized for their order.
+ */
+int main(int argc, char *argv[]) {
+    bool withStats = false, withDancingLinks = false, withClauseLearning = false, withKernel = false;
+    bool inBatches = false, isComparing = false, hasStrategy = false, isDeterministic = false;
+    SuDoKuOrdering ordering = kMostConstrainedOrdering;
+    int numThreads = 0, order = kBoardOrder;
+    uint64_t countLimit = 0, numToGenerate = 0, seed = 1;
+    string rulesFilename, outFilename;
+    vector<string> filenames;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-stats") withStats = true;
+        else if (arg == "-dlx") withDancingLinks = true;
+        else if (arg == "-cdcl") withClauseLearning = true;
+        else if (arg == "-simd") withKernel = true;
+        else if (arg == "-batch") inBatches = true;
+        else if (arg == "-compare") isComparing = true;
+        else if (arg == "-deterministic") isDeterministic = true;
+        else if (arg == "-threads" && i + 1 < argc) numThreads = atoi(argv[++i]);
+        else if (arg == "-order" && i + 1 < argc) order = atoi(argv[++i]);
+        else if (arg == "-count" && i + 1 < argc) countLimit = strtoull(argv[++i], NULL, 10);
+        else if (arg == "-generate" && i + 1 < argc) numToGenerate = strtoull(argv[++i], NULL, 10);
+        else if (arg == "-seed" && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (arg == "-rules" && i + 1 < argc) rulesFilename = argv[++i];
+        else if (arg == "-out" && i + 1 < argc) outFilename = argv[++i];
+        else if (arg == "-read" && i + 1 < argc) return printStream(argv[++i]) ? 0 : 1;
+        else if (arg == "-strategy" && i + 1 < argc) {
+            if (!findOrdering(argv[++i], ordering)) {
+                cerr << "Unknown strategy " << argv[i] << endl;
+                return 1;
+            }
+            hasStrategy = true;
+        }
+        else filenames.push_back(arg);
+    }
+
+    if (numToGenerate != 0) {
+        generateAll(numToGenerate, seed, numThreads, withStats);
+        return 0;
+    }
+
+    if (countLimit != 0 && (inBatches || withDancingLinks || !outFilename.empty())) {
+        cerr << "-count can't be combined with -batch, -dlx, or -out" << endl;
+        return 1;
+    }
+
+    if (withClauseLearning && (inBatches || withDancingLinks || countLimit != 0)) {
+        cerr << "-cdcl can't be combined with -batch, -dlx, or -count" << endl;
+        return 1;
+    }
+
+    if ((hasStrategy || isComparing) && (inBatches || withDancingLinks || withClauseLearning || countLimit != 0)) {
+        cerr << "-strategy and -compare can't be combined with -batch, -dlx, -cdcl, or -count" << endl;
+        return 1;
+    }
+
+    if (!rulesFilename.empty() && (inBatches || withDancingLinks || withClauseLearning)) {
+        cerr << "-rules can't be combined with -batch, -dlx, or -cdcl" << endl;
+        return 1;
+    }
+
+    if (isComparing) {
+        if (hasStrategy || numThreads != 0 || !outFilename.empty()) {
+            cerr << "-compare can't be combined with -strategy, -threads, or -out" << endl;
+            return 1;
+        }
+        switch (order) {
+            case 2: return compareStrategies<2>(filenames, rulesFilename, seed) ? 0 : 1;
+            case 3: return compareStrategies<3>(filenames, rulesFilename, seed) ? 0 : 1;
+            case 4: return compareStrategies<4>(filenames, rulesFilename, seed) ? 0 : 1;
+            case 5: return compareStrategies<5>(filenames, rulesFilename, seed) ? 0 : 1;
+            case 6: return compareStrategies<6>(filenames, rulesFilename, seed) ? 0 : 1;
+        }
+        cerr << "The order must be between " << kMinBoardOrder << " and " << kMaxBoardOrder << endl;
+        return 1;
+    }
+
+    if (numThreads != 0 && !inBatches && (withDancingLinks || withClauseLearning || countLimit != 0)) {
+        cerr << "-threads can't be combined with -dlx, -cdcl, or -count without -batch" << endl;
+        return 1;
+    }
+
+    if (isDeterministic && (numThreads == 0 || inBatches)) {
+        cerr << "-deterministic requires -threads and can't be combined with -batch" << endl;
+        return 1;
+    }
+
+    if (isDeterministic && ordering == kRandomizedOrdering) {
+        cerr << "-deterministic can't be combined with -strategy mrv-random" << endl;
+        return 1;
+    }
+
+    if (withKernel && (!inBatches || withDancingLinks)) {
+        cerr << "-simd requires -batch and can't be combined with -dlx" << endl;
+        return 1;
+    }
+
+    if (inBatches) {
+        if (!outFilename.empty()) {
+            cerr << "-out can't be combined with -batch" << endl;
+            return 1;
+        }
+        if (order != kBoardOrder) {
+            cerr << "-batch only solves puzzles of order " << kBoardOrder << endl;
+            return 1;
+        }
+        SuDoKuBatchMethod method = withKernel ? kKernelMethod :
+                                   withDancingLinks ? kDancingLinksMethod : kSearchMethod;
+        return solveInBatches(filenames, numThreads, method, withStats) ? 0 : 1;
+    }
+
+    switch (order) {
+        case 2: return solveWithOrder<2>(filenames, withStats, withDancingLinks, withClauseLearning, ordering,
+                                         rulesFilename, numThreads, isDeterministic, outFilename, countLimit);
+        case 3: return solveWithOrder<3>(filenames, withStats, withDancingLinks, withClauseLearning, ordering,
+                                         rulesFilename, numThreads, isDeterministic, outFilename, countLimit);
+        case 4: return solveWithOrder<4>(filenames, withStats, withDancingLinks, withClauseLearning, ordering,
+                                         rulesFilename, numThreads, isDeterministic, outFilename, countLimit);
+        case 5: return solveWithOrder<5>(filenames, withStats, withDancingLinks, withClauseLearning, ordering,
+                                         rulesFilename, numThreads, isDeterministic, outFilename, countLimit);
+        case 6: return solveWithOrder<6>(filenames, withStats, withDancingLinks, withClauseLearning, ordering,
+                                         rulesFilename, numThreads, isDeterministic, outFilename, countLimit);
+    }
+    cerr << "The order must be between " << kMinBoardOrder << " and " << kMaxBoardOrder << endl;
+    return 1;
+}
@@ -0,0 +1,73 @@
+# Qt Creator project file for the headless SuDoKu solver
+#
+# Builds the SuDoKu search as a plain command-line program.  Only the
+# solver sources from ../src and the code shared by both puzzles in
+# ../../shared are compiled, and the Stanford C++ library is left out
+# entirely, so the program never launches the Java back-end and can be
+# run from scripts and batch jobs.
+
+TEMPLATE = app
+TARGET = sudoku-headless
+CONFIG += console
+CONFIG -= qt
+CONFIG -= app_bundle
+CONFIG += warn_off
+CONFIG += c++11
+
+SOURCES *= $$PWD/sudoku-headless.cpp
+SOURCES *= $$PWD/../src/sudoku-batch.cpp
+SOURCES *= $$PWD/../src/sudoku-board.cpp
+SOURCES *= $$PWD/../src/sudoku-cdcl.cpp
+SOURCES *= $$PWD/../src/sudoku-exact-cover.cpp
+SOURCES *= $$PWD/../src/sudoku-generator.cpp
+SOURCES *= $$PWD/../src/sudoku-kernel.cpp
+SOURCES *= $$PWD/../src/sudoku-rules.cpp
+SOURCES *= $$PWD/../src/sudoku-solver.cpp
+SOURCES *= $$PWD/../src/sudoku-stats.cpp
+SOURCES *= $$PWD/../src/sudoku-strategy.cpp
+SOURCES *= $$PWD/../../shared/exact-cover.cpp
+SOURCES *= $$PWD/../../shared/mapped-file.cpp
+SOURCES *= $$PWD/../../shared/solution-stream.cpp
+
+HEADERS *= $$PWD/../src/sudoku-batch.h
+HEADERS *= $$PWD/../src/sudoku-board.h
+HEADERS *= $$PWD/../src/sudoku-cdcl.h
+HEADERS *= $$PWD/../src/sudoku-constants.h
+HEADERS *= $$PWD/../src/sudoku-exact-cover.h
+HEADERS *= $$PWD/../src/sudoku-generator.h
+HEADERS *= $$PWD/../src/sudoku-kernel.h
+HEADERS *= $$PWD/../src/sudoku-observers.h
+HEADERS *= $$PWD/../src/sudoku-rules.h
+HEADERS *= $$PWD/../src/sudoku-solver.h
+HEADERS *= $$PWD/../src/sudoku-stats.h
+HEADERS *= $$PWD/../src/sudoku-strategy.h
+HEADERS *= $$PWD/../../shared/backtracking.h
+HEADERS *= $$PWD/../../shared/exact-cover.h
+HEADERS *= $$PWD/../../shared/mapped-file.h
+HEADERS *= $$PWD/../../shared/parallel-backtracking.h
+HEADERS *= $$PWD/../../shared/solution-stream.h
+HEADERS *= $$PWD/../../shared/stopwatch.h
+HEADERS *= $$PWD/../../shared/work-stealing-deque.h
+
+INCLUDEPATH *= $$PWD/../src/
+INCLUDEPATH *= $$PWD/../../shared/
+
+QMAKE_CXXFLAGS += -Wall
+QMAKE_CXXFLAGS += -Wextra
+QMAKE_CXXFLAGS += -Werror=return-type
+QMAKE_CXXFLAGS += -Werror=uninitialized
+QMAKE_CXXFLAGS += -Wno-sign-compare
+
+# qmake CONFIG+=sudoku_stats compiles in the search counters that -stats
+# prints (see sudoku-stats.h), which are left out by default
+sudoku_stats {
+    DEFINES += SUDOKU_ENABLE_STATS
+}
+
+!win32 {
+    LIBS += -lpthread
+}
+
+CONFIG(release, debug|release) {
+    QMAKE_CXXFLAGS += -O3
+}
@@ -176,6 +176,9 @@ exists($$PWD/src/test/*.cpp) {
 exists($$PWD/$$PROJECT_FILTER*.cpp) {
     SOURCES *= $$PWD/$$PROJECT_FILTER*.cpp
 }
+exists($$PWD/../shared/*.cpp) {
+    SOURCES *= $$PWD/../shared/*.cpp
+}
 
 exists($$PWD/lib/StanfordCPPLib/*.h) {
     HEADERS *= $$PWD/lib/StanfordCPPLib/*.h
@@ -195,6 +198,9 @@ exists($$PWD/src/$$PROJECT_FILTER*.h) {
 exists($$PWD/$$PROJECT_FILTER*.h) {
     HEADERS *= $$PWD/$$PROJECT_FILTER*.h
 }
+exists($$PWD/../shared/*.h) {
+    HEADERS *= $$PWD/../shared/*.h
+}
 
 # directories examined by Qt Creator when student writes an #include statement
 INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/
@@ -205,6 +211,7 @@ INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/system/
 INCLUDEPATH *= $$PWD/lib/StanfordCPPLib/util/
 INCLUDEPATH *= $$PWD/src/
 INCLUDEPATH *= $$PWD/
+INCLUDEPATH *= $$PWD/../shared/
 exists($$PWD/src/autograder/*.h) {
     INCLUDEPATH *= $$PWD/src/autograder/
 }
@@ -305,6 +312,7 @@ unix:!macx {
     #QMAKE_CXXFLAGS += -Wno-dangling-field
     QMAKE_CXXFLAGS += -Wno-unused-const-variable
     LIBS += -ldl
+    LIBS += -lpthread
 }
 
 # set up configuration flags used internally by the Stanford C++ libraries
@@ -0,0 +1,146 @@
+/**
+ * File: sudoku-batch.cpp
+ * ----------------------
+ * Presents the implementation of the SuDoKuBatchSolver class.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "mapped-file.h"
+#include "sudoku-batch.h"
+#include "sudoku-board.h"
+#include "sudoku-exact-cover.h"
+#include "sudoku-kernel.h"
+#include "sudoku-solver.h"
+using namespace std;
+
+/* Constants */
+static const size_t kBatchBlockSize = 64 * 1024; // bytes of input per block, about 800 puzzles
+
+SuDoKuBatchSolver::SuDoKuBatchSolver(int numThreads, SuDoKuBatchMethod method) :
+    numThreads(numThreads > 0 ? numThreads : max(1, (int) thread::hardware_concurrency())),
+    method(method),
+    numPuzzles(0),
+    numSolved(0),
+    text(NULL),
+    nextBlock(0),
+    nextToWrite(0),
+    out(NULL) {}
+
+void SuDoKuBatchSolver::solve(const char *text, size_t size, ostream& out) {
+    this->text = text;
+    this->out = &out;
+    splitIntoBlocks(size);
+    size_t numBlocks = blockStarts.size() - 1;
+    results.assign(numBlocks, string());
+    isFinished.assign(numBlocks, false);
+    nextBlock = 0;
+    nextToWrite = 0;
+
+    vector<thread> workers;
+    int numWorkers = min<size_t>(numThreads, numBlocks);
+    for (int i = 1; i < numWorkers; i++) {
+        workers.push_back(thread(&SuDoKuBatchSolver::work, this));
+    }
+    work();
+    for (thread& worker: workers) {
+        worker.join();
+    }
+    out.flush();
+}
+
+bool SuDoKuBatchSolver::solveFile(const string& filename, ostream& out) {
+    MappedFile file(filename);
+    if (!file.isOpen()) return false;
+    solve(reinterpret_cast<const char *>(file.getData()), file.getSize(), out);
+    return true;
+}
+
+/**
+ * Method: splitIntoBlocks
+ * -----------------------
+ * Cuts the text into blocks of about kBatchBlockSize bytes, extending each
+ * to the end of the line it would otherwise end in the middle of.
+ */
+void SuDoKuBatchSolver::splitIntoBlocks(size_t size) {
+    blockStarts.clear();
+    size_t start = 0;
+    while (start < size) {
+        blockStarts.push_back(start);
+        size_t end = start + kBatchBlockSize;
+        if (end >= size) break;
+        const char *newline = static_cast<const char *>(memchr(text + end, '\n', size - end));
+        start = newline == NULL ? size : newline - text + 1;
+    }
+    blockStarts.push_back(size);
+}
+
+/**
+ * Method: work
+ * ------------
+ * Runs on every thread, claiming blocks until there are none left and
+ * solving the puzzles in each.  Every thread has its own board and, if
+ * needed, its own exact cover matrix or kernel, so the threads share
+ * nothing but the counters and the reorder buffer.  Each thread publishes
+ * its search statistics, if they're compiled in, once it runs out of work.
+ */
+void SuDoKuBatchSolver::work() {
+    SuDoKuExactCover *dlx = method == kDancingLinksMethod ? new SuDoKuExactCover() : NULL;
+    SuDoKuKernel *kernel = method == kKernelMethod ? new SuDoKuKernel() : NULL;
+    SuDoKuBoard board;
+    string output;
+    size_t numBlocks = blockStarts.size() - 1;
+    for (size_t block = nextBlock++; block < numBlocks; block = nextBlock++) {
+        uint64_t numBlockPuzzles = 0, numBlockSolved = 0;
+        const char *line = text + blockStarts[block], *blockEnd = text + blockStarts[block + 1];
+        while (line < blockEnd) {
+            const char *newline = static_cast<const char *>(memchr(line, '\n', blockEnd - line));
+            const char *lineEnd = newline == NULL ? blockEnd : newline;
+            size_t length = lineEnd - line;
+            if (length > 0 && line[length - 1] == '\r') length--;
+            if (length > 0) {
+                numBlockPuzzles++;
+                if (!board.load(line, length)) {
+                    output += "invalid\n";
+                } else if (dlx != NULL ? dlx->solve(board) : kernel != NULL ? kernel->solve(board) : ::solve(board)) {
+                    numBlockSolved++;
+                    for (int row = 0; row < kBoardDimension; row++) {
+                        for (int col = 0; col < kBoardDimension; col++) {
+                            output += char('0' + board[row][col]);
+                        }
+                    }
+                    output += '\n';
+                } else {
+                    output += "unsolvable\n";
+                }
+            }
+            line = lineEnd + 1;
+        }
+        numPuzzles += numBlockPuzzles;
+        numSolved += numBlockSolved;
+        finishBlock(block, output);
+    }
+    delete dlx;
+    delete kernel;
+    SUDOKU_STATS(publishSuDoKuStats());
+}
+
+/**
+ * Method: finishBlock
+ * -------------------
+ * Hands the output of a solved block to the reorder buffer, and then
+ * writes every block that's now ready, in order.  The output string is
+ * swapped with the buffer's empty one, so it comes back empty, with no
+ * copying either way.
+ */
+void SuDoKuBatchSolver::finishBlock(size_t block, string& output) {
+    lock_guard<mutex> guard(outputLock);
+    results[block].swap(output);
+    isFinished[block] = true;
+    while (nextToWrite < results.size() && isFinished[nextToWrite]) {
+        out->write(results[nextToWrite].data(), results[nextToWrite].size());
+        string().swap(results[nextToWrite]);
+        nextToWrite++;
+    }
+}
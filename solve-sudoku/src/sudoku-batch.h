@@ -0,0 +1,104 @@
+/**
+ * File: sudoku-batch.h
+ * --------------------
+ * Defines the SuDoKuBatchSolver class, which solves files of puzzles as
+ * fast as the machine allows, spreading them across a pool of threads
+ * while still writing the solutions in the order the puzzles were read.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Type: SuDoKuBatchMethod
+ * -----------------------
+ * Identifies how the puzzles are solved: by the backtracking search in
+ * sudoku-solver.h, as exact cover problems (see sudoku-exact-cover.h), or
+ * by the vectorized kernel in sudoku-kernel.h.
+ */
+enum SuDoKuBatchMethod {
+    kSearchMethod,
+    kDancingLinksMethod,
+    kKernelMethod
+};
+
+/**
+ * Class: SuDoKuBatchSolver
+ * ------------------------
+ * Solves puzzles listed one per line, as 81 characters with '0' or '.' for
+ * empty cells, and writes one line per puzzle: its solution in the same
+ * form, or "invalid" or "unsolvable".  The input is cut into blocks of
+ * whole lines, about kBatchBlockSize bytes each, which the threads claim
+ * one at a time, so a thread that draws easy puzzles simply claims more
+ * blocks.  Each block's output is collected in memory, and a reorder
+ * buffer holds the blocks that finish early until every block before them
+ * has been written, so the output matches a single-threaded run exactly.
+ */
+class SuDoKuBatchSolver {
+public:
+
+    /**
+     * Constructor: SuDoKuBatchSolver
+     * ------------------------------
+     * Constructs a solver that uses up to numThreads threads, each of which
+     * solves puzzles by the provided method.  If numThreads is 0, one thread
+     * is used per hardware thread.
+     */
+    SuDoKuBatchSolver(int numThreads = 0, SuDoKuBatchMethod method = kSearchMethod);
+
+    /**
+     * Method: solve
+     * -------------
+     * Solves every puzzle in the size bytes of text, writing the results
+     * to out.
+     */
+    void solve(const char *text, size_t size, std::ostream& out);
+
+    /**
+     * Method: solveFile
+     * -----------------
+     * Solves every puzzle in the named file, which is memory-mapped rather
+     * than read through a stream.  Returns false if the file can't be opened.
+     */
+    bool solveFile(const std::string& filename, std::ostream& out);
+
+    /**
+     * Methods: getNumThreads, getPuzzleCount, getSolvedCount
+     * ------------------------------------------------------
+     * Report the number of threads used, and the number of puzzles read and
+     * solved over every call to solve so far.
+     */
+    int getNumThreads() const { return numThreads; }
+    uint64_t getPuzzleCount() const { return numPuzzles; }
+    uint64_t getSolvedCount() const { return numSolved; }
+
+private:
+    int numThreads;
+    SuDoKuBatchMethod method;
+    std::atomic<uint64_t> numPuzzles;
+    std::atomic<uint64_t> numSolved;
+
+    // the state of the call to solve in progress
+    const char *text;
+    std::vector<size_t> blockStarts;     // blockStarts[b] is the offset of block b, with one extra for the end
+    std::atomic<size_t> nextBlock;       // the next block to be claimed
+    std::vector<std::string> results;    // results[b] is the output of block b, once it's been solved
+    std::vector<char> isFinished;        // isFinished[b] is true once results[b] is ready to be written
+    size_t nextToWrite;                  // the first block not yet written
+    std::ostream *out;
+    std::mutex outputLock;               // guards results, isFinished, nextToWrite, and out
+
+    void splitIntoBlocks(size_t size);
+    void work();
+    void finishBlock(size_t block, std::string& output);
+
+    SuDoKuBatchSolver(const SuDoKuBatchSolver&);              // not copyable
+    SuDoKuBatchSolver& operator=(const SuDoKuBatchSolver&);
+};
@@ -0,0 +1,121 @@
+/**
+ * File: sudoku-board.cpp
+ * ----------------------
+ * Presents the implementation of the BasicSuDoKuBoard class template,
+ * which is instantiated here for every supported order.
+ */
+
+#include <cctype>
+#include "sudoku-board.h"
+using namespace std;
+
+/* Constants */
+static const string kSymbols = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+char symbolFor(int digit) {
+    return digit >= 0 && digit < (int) kSymbols.size() ? kSymbols[digit] : '\0';
+}
+
+int digitFor(char symbol) {
+    if (symbol == '.') return kEmpty;
+    if (symbol >= '0' && symbol <= '9') return symbol - '0';
+    if (isalpha((unsigned char) symbol)) return toupper((unsigned char) symbol) - 'A' + 10;
+    return -1;
+}
+
+template <int Order>
+BasicSuDoKuBoard<Order>::BasicSuDoKuBoard() {
+    clear();
+}
+
+template <int Order>
+void BasicSuDoKuBoard<Order>::clear() {
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            cells[row][col] = kEmpty;
+        }
+    }
+}
+
+template <int Order>
+bool BasicSuDoKuBoard<Order>::load(const string& puzzle) {
+    return load(puzzle.data(), puzzle.size());
+}
+
+template <int Order>
+bool BasicSuDoKuBoard<Order>::load(const char *puzzle, size_t length) {
+    if (loadCompact(puzzle, length) || loadSeparated(puzzle, length)) return true;
+    clear();
+    return false;
+}
+
+/**
+ * Method: loadCompact
+ * -------------------
+ * Loads a puzzle given with one symbol per cell, returning false if it
+ * isn't of that form.
+ */
+template <int Order>
+bool BasicSuDoKuBoard<Order>::loadCompact(const char *puzzle, size_t length) {
+    if (length != kDimension * kDimension) return false;
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            int digit = digitFor(puzzle[row * kDimension + col]);
+            if (digit < 0 || digit > kDimension) return false;
+            cells[row][col] = digit;
+        }
+    }
+    return true;
+}
+
+/**
+ * Method: loadSeparated
+ * ---------------------
+ * Loads a puzzle whose cells are separated by whitespace, returning false
+ * if it isn't of that form.  A cell of more than one character must be a
+ * number.
+ */
+template <int Order>
+bool BasicSuDoKuBoard<Order>::loadSeparated(const char *puzzle, size_t length) {
+    int numCells = 0;
+    const char *end = puzzle + length;
+    while (true) {
+        while (puzzle < end && isspace((unsigned char) *puzzle)) puzzle++;
+        if (puzzle == end) break;
+        const char *start = puzzle;
+        while (puzzle < end && !isspace((unsigned char) *puzzle)) puzzle++;
+        int digit = -1;
+        if (puzzle - start == 1) {
+            digit = digitFor(*start);
+        } else if (puzzle - start <= 2 && isdigit((unsigned char) start[0]) && isdigit((unsigned char) start[1])) {
+            digit = (start[0] - '0') * 10 + start[1] - '0';
+        }
+        if (digit < 0 || digit > kDimension || numCells == kDimension * kDimension) return false;
+        cells[numCells / kDimension][numCells % kDimension] = digit;
+        numCells++;
+    }
+    return numCells == kDimension * kDimension;
+}
+
+template <int Order>
+string BasicSuDoKuBoard<Order>::toString() const {
+    bool isCompact = symbolFor(kDimension) != '\0';
+    string puzzle;
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            if (isCompact) {
+                puzzle += symbolFor(cells[row][col]);
+            } else {
+                if (!puzzle.empty()) puzzle += ' ';
+                puzzle += to_string(cells[row][col]);
+            }
+        }
+    }
+    return puzzle;
+}
+
+template class BasicSuDoKuBoard<2>;
+template class BasicSuDoKuBoard<3>;
+template class BasicSuDoKuBoard<4>;
+template class BasicSuDoKuBoard<5>;
+template class BasicSuDoKuBoard<6>;
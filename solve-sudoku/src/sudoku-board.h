@@ -0,0 +1,105 @@
+/**
+ * File: sudoku-board.h
+ * --------------------
+ * Defines the BasicSuDoKuBoard class template, which models the contents of
+ * a SuDoKu board using nothing beyond the standard library, so that the
+ * solver can be built into programs that never launch the Stanford graphics
+ * back end.  The board's order is a template parameter, so the classic 9 x 9
+ * board and the larger ones each get code specialized to their size.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "sudoku-constants.h"
+
+/**
+ * Function: symbolFor
+ * -------------------
+ * Returns the single character that stands for the digit in the compact
+ * form of a board: '0' for kEmpty, '1' through '9', and then 'A' through
+ * 'Z' for 10 through 35.  Returns '\0' for digits with no symbol.
+ */
+char symbolFor(int digit);
+
+/**
+ * Function: digitFor
+ * ------------------
+ * Returns the digit the symbol stands for, the reverse of symbolFor, with
+ * '.' standing for kEmpty too and letters read in either case.  Returns -1
+ * if the character doesn't stand for anything.
+ */
+int digitFor(char symbol);
+
+/**
+ * Class: BasicSuDoKuBoard
+ * -----------------------
+ * Stores one digit (or kEmpty) per cell of a board whose blocks are
+ * Order x Order, so that the board itself is Order^2 x Order^2 and uses the
+ * digits from 1 through Order^2.  board[row][col] reads and writes cells
+ * just as it does for a Grid<int>.  Only the orders from kMinBoardOrder
+ * through kMaxBoardOrder are instantiated.
+ */
+template <int Order>
+class BasicSuDoKuBoard {
+public:
+    static const int kOrder = Order;
+    static const int kDimension = Order * Order; // the number of rows, columns, blocks, and digits
+
+    /**
+     * Constructor: BasicSuDoKuBoard
+     * -----------------------------
+     * Constructs a board where every location is unoccupied.
+     */
+    BasicSuDoKuBoard();
+
+    /**
+     * Operator: []
+     * ------------
+     * Provides access to the specified row, so that board[row][col] is
+     * the digit at (row, col).
+     */
+    int *operator[](int row) { return cells[row]; }
+    const int *operator[](int row) const { return cells[row]; }
+
+    /**
+     * Method: load
+     * ------------
+     * Replaces the contents of the board with the puzzle described by the
+     * provided string, which lists the cells row by row in one of two forms.
+     * The compact form is exactly kDimension * kDimension characters, one
+     * per cell, as given by symbolFor, with '0' or '.' for an empty cell.
+     * Otherwise, the cells are separated by whitespace, and each is a number
+     * from 0 through kDimension or a single symbol, so boards too large for
+     * one character per cell can be described too.  Returns false, leaving
+     * the board empty, if the string isn't of either form.  The second
+     * version reads the puzzle from the length characters at puzzle, which
+     * needn't be null-terminated.
+     */
+    bool load(const std::string& puzzle);
+    bool load(const char *puzzle, size_t length);
+
+    /**
+     * Method: toString
+     * ----------------
+     * Returns the contents of the board in a form accepted by load: the
+     * compact form, using '0' for empty cells, if every digit has a symbol,
+     * and the numbers separated by spaces otherwise.
+     */
+    std::string toString() const;
+
+private:
+    int cells[kDimension][kDimension];
+    void clear();
+    bool loadCompact(const char *puzzle, size_t length);
+    bool loadSeparated(const char *puzzle, size_t length);
+};
+
+/**
+ * Type: SuDoKuBoard
+ * -----------------
+ * The classic 9 x 9 board, which is the only one the display knows how
+ * to draw.
+ */
+typedef BasicSuDoKuBoard<kBoardOrder> SuDoKuBoard;
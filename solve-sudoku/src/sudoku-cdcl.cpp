@@ -0,0 +1,588 @@
+/**
+ * File: sudoku-cdcl.cpp
+ * ---------------------
+ * Presents the implementation of the methods of the BasicSuDoKuCDCL class
+ * template that don't depend on the display, instantiated here for every
+ * supported order.  Literals are numbered 2 * variable for the variable
+ * being true and 2 * variable + 1 for it being false, so a literal's
+ * negation is the literal XOR 1.  The reason a variable was assigned is
+ * kNoReason for decisions and givens, the index of the clause that forced
+ * it, or -2 - x when it was forced false by the peer variable x being true.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "sudoku-cdcl.h"
+using namespace std;
+
+/* Constants */
+static const int kNoReason = -1;
+static const double kVariableDecay = 0.95;
+static const double kClauseDecay = 0.999;
+static const double kRescaleLimit = 1e100;
+static const uint64_t kRestartUnit = 100;       // conflicts per unit of the Luby sequence
+static const uint64_t kFirstReduction = 2000;   // conflicts before the learned clauses are first reduced
+static const uint64_t kReductionIncrement = 300;
+static const int kKeptSpan = 2;                 // learned clauses spanning this few levels are never deleted
+
+/**
+ * Function: luby
+ * --------------
+ * Returns the index-th term (counting from 0) of the Luby sequence
+ * 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ..., which restarts often but now and then
+ * lets a search run long.
+ */
+static uint64_t luby(uint64_t index) {
+    uint64_t size = 1;
+    int power = 0;
+    while (size < index + 1) {
+        power++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) / 2;
+        power--;
+        index %= size;
+    }
+    return uint64_t(1) << power;
+}
+
+/**
+ * Implementation notes: constructor
+ * ---------------------------------
+ * The clauses are laid out as the columns of BasicSuDoKuExactCover are:
+ * one per location, then one per digit within each row, column, and block.
+ */
+template <int Order>
+BasicSuDoKuCDCL<Order>::BasicSuDoKuCDCL() :
+    watches(2 * kNumVariables),
+    numDecisions(0),
+    numConflicts(0),
+    numRestarts(0) {
+    vector<int> units[3 * kDimension];
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            int cell = row * kDimension + col;
+            units[row].push_back(cell);
+            units[kDimension + col].push_back(cell);
+            units[2 * kDimension + row / Order * Order + col / Order].push_back(cell);
+        }
+    }
+
+    for (int cell = 0; cell < kNumCells; cell++) {
+        Clause clause = { vector<int>(), 0, 0 };
+        for (int digit = 1; digit <= kDimension; digit++) {
+            clause.literals.push_back(getLiteral(getVariable(cell, digit), true));
+        }
+        clauses.push_back(clause);
+    }
+    for (const vector<int>& unit: units) {
+        for (int digit = 1; digit <= kDimension; digit++) {
+            Clause clause = { vector<int>(), 0, 0 };
+            for (int cell: unit) {
+                clause.literals.push_back(getLiteral(getVariable(cell, digit), true));
+            }
+            clauses.push_back(clause);
+        }
+    }
+    numOriginal = clauses.size();
+
+    for (int cell = 0; cell < kNumCells; cell++) {
+        int row = cell / kDimension, col = cell % kDimension;
+        for (int other = 0; other < kNumCells; other++) {
+            int otherRow = other / kDimension, otherCol = other % kDimension;
+            if (other == cell) continue;
+            if (otherRow == row || otherCol == col ||
+                (otherRow / Order == row / Order && otherCol / Order == col / Order)) {
+                peers.push_back(other);
+            }
+        }
+    }
+}
+
+/**
+ * Method: reset
+ * -------------
+ * Forgets every learned clause and assignment of the previous search.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::reset() {
+    clauses.resize(numOriginal);
+    for (vector<Watcher>& list: watches) list.clear();
+    for (size_t clause = 0; clause < clauses.size(); clause++) attach(clause);
+
+    values.assign(kNumVariables, -1);
+    levels.assign(kNumVariables, 0);
+    reasons.assign(kNumVariables, kNoReason);
+    phases.assign(kNumVariables, true);
+    seen.assign(kNumVariables, false);
+    trail.clear();
+    levelStarts.clear();
+    propagated = 0;
+
+    activities.assign(kNumVariables, 0);
+    heap.clear();
+    heapIndices.assign(kNumVariables, -1);
+    variableBump = 1;
+    clauseBump = 1;
+    numDecisions = numConflicts = numRestarts = 0;
+}
+
+/**
+ * Implementation notes: search
+ * ----------------------------
+ * The givens are assigned and propagated at level 0, and each remaining
+ * variable starts with an activity of one over the number of options its
+ * location has left, so that, until conflicts say otherwise, the search
+ * decides the most constrained locations first.
+ */
+template <int Order>
+bool BasicSuDoKuCDCL<Order>::search(const Board& board) {
+    reset();
+    for (int cell = 0; cell < kNumCells; cell++) {
+        int digit = board[cell / kDimension][cell % kDimension];
+        if (digit == kEmpty) continue;
+        int variable = getVariable(cell, digit);
+        if (values[variable] == 0) return false;
+        if (values[variable] == -1) assign(getLiteral(variable, true), kNoReason);
+    }
+    int conflict, conflictLiteral;
+    if (!propagate(conflict, conflictLiteral)) return false;
+
+    for (int cell = 0; cell < kNumCells; cell++) {
+        int numOptions = 0;
+        for (int digit = 1; digit <= kDimension; digit++) {
+            if (values[getVariable(cell, digit)] == -1) numOptions++;
+        }
+        for (int digit = 1; digit <= kDimension; digit++) {
+            int variable = getVariable(cell, digit);
+            if (values[variable] != -1) continue;
+            activities[variable] = 1.0 / numOptions;
+            heapInsert(variable);
+        }
+    }
+
+    uint64_t restartLimit = kRestartUnit * luby(0), numSinceRestart = 0;
+    uint64_t nextReduction = kFirstReduction, numReductions = 0;
+    while (true) {
+        if (!propagate(conflict, conflictLiteral)) {
+            numConflicts++;
+            numSinceRestart++;
+            if (getLevel() == 0) return false;
+            int backjumpLevel;
+            analyze(conflict, conflictLiteral, backjumpLevel);
+            backjump(backjumpLevel);
+            learn();
+            variableBump /= kVariableDecay;
+            clauseBump /= kClauseDecay;
+            continue;
+        }
+
+        if (numSinceRestart >= restartLimit) {
+            numRestarts++;
+            numSinceRestart = 0;
+            restartLimit = kRestartUnit * luby(numRestarts);
+            backjump(0);
+            continue;
+        }
+        if (numConflicts >= nextReduction) {
+            numReductions++;
+            nextReduction = numConflicts + kFirstReduction + kReductionIncrement * numReductions;
+            reduce();
+        }
+
+        int literal = chooseLiteral();
+        if (literal == -1) return true;
+        numDecisions++;
+        levelStarts.push_back(trail.size());
+        assign(literal, kNoReason);
+    }
+}
+
+template <int Order>
+void BasicSuDoKuCDCL<Order>::assign(int literal, int reason) {
+    int variable = literal >> 1;
+    values[variable] = (literal & 1) == 0;
+    levels[variable] = getLevel();
+    reasons[variable] = reason;
+    trail.push_back(literal);
+}
+
+/**
+ * Implementation notes: propagate
+ * -------------------------------
+ * Works through the trail, applying the peer table for each variable
+ * assigned true and then visiting the clauses watching the literal each
+ * assignment made false.  Every clause watches its first two literals, and
+ * a watcher whose blocker is true needn't look at its clause at all.  If a
+ * clause has no other literal to watch, its first literal is forced, or,
+ * if that's false too, the clause is the conflict.  A conflict between
+ * peers is reported as -2 - x, where x is the variable being propagated,
+ * with conflictLiteral the negation of the peer that's also true.
+ */
+template <int Order>
+bool BasicSuDoKuCDCL<Order>::propagate(int& conflict, int& conflictLiteral) {
+    const size_t kNumPeers = peers.size() / kNumCells;
+    while (propagated < trail.size()) {
+        int literal = trail[propagated++];
+        int variable = literal >> 1;
+        if ((literal & 1) == 0) {
+            int cell = variable / kDimension, digit = variable % kDimension + 1;
+            for (size_t i = 0; i < kNumPeers + kDimension; i++) {
+                int other = i < kDimension ? getVariable(cell, i + 1) :
+                                             getVariable(peers[cell * kNumPeers + i - kDimension], digit);
+                if (other == variable || values[other] == 0) continue;
+                if (values[other] == 1) {
+                    conflict = -2 - variable;
+                    conflictLiteral = getLiteral(other, false);
+                    propagated = trail.size();
+                    return false;
+                }
+                assign(getLiteral(other, false), -2 - variable);
+            }
+        }
+
+        int falseLiteral = literal ^ 1;
+        vector<Watcher>& list = watches[falseLiteral];
+        size_t kept = 0, next = 0;
+        while (next < list.size()) {
+            Watcher watcher = list[next++];
+            int blocker = values[watcher.blocker >> 1];
+            if (blocker != -1 && (blocker ^ (watcher.blocker & 1)) == 1) {
+                list[kept++] = watcher;
+                continue;
+            }
+
+            vector<int>& literals = clauses[watcher.clause].literals;
+            if (literals[0] == falseLiteral) swap(literals[0], literals[1]);
+            int first = literals[0], firstValue = values[first >> 1];
+            if (firstValue != -1) firstValue ^= first & 1;
+            if (firstValue == 1) {
+                Watcher satisfied = { watcher.clause, first };
+                list[kept++] = satisfied;
+                continue;
+            }
+
+            bool isMoved = false;
+            for (size_t k = 2; k < literals.size(); k++) {
+                int value = values[literals[k] >> 1];
+                if (value != -1 && (value ^ (literals[k] & 1)) == 0) continue;
+                literals[1] = literals[k];
+                literals[k] = falseLiteral;
+                Watcher moved = { watcher.clause, first };
+                watches[literals[1]].push_back(moved);
+                isMoved = true;
+                break;
+            }
+            if (isMoved) continue;
+
+            list[kept++] = watcher;
+            if (firstValue == 0) {
+                while (next < list.size()) list[kept++] = list[next++];
+                list.resize(kept);
+                conflict = watcher.clause;
+                conflictLiteral = -1;
+                propagated = trail.size();
+                return false;
+            }
+            assign(first, watcher.clause);
+        }
+        list.resize(kept);
+    }
+    return true;
+}
+
+/**
+ * Implementation notes: analyze
+ * -----------------------------
+ * Resolves the conflict with the reasons of its literals from the current
+ * level, latest first, until only one literal from that level is left: the
+ * first unique implication point, whose negation heads the learned clause.
+ * Literals from earlier levels go straight into the clause, and literals
+ * from level 0 are dropped, since they hold for the rest of the search.
+ * Every variable met along the way has its activity bumped.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::analyze(int conflict, int conflictLiteral, int& backjumpLevel) {
+    learned.assign(1, -1);
+    int numAtLevel = 0, literal = -1, reason = conflict;
+    size_t index = trail.size();
+    auto visit = [&](int falseLiteral) {
+        int variable = falseLiteral >> 1;
+        if (seen[variable] || levels[variable] == 0) return;
+        seen[variable] = true;
+        bumpVariable(variable);
+        if (levels[variable] == getLevel()) numAtLevel++;
+        else learned.push_back(falseLiteral);
+    };
+
+    while (true) {
+        if (reason >= 0) {
+            bumpClause(reason);
+            const vector<int>& literals = clauses[reason].literals;
+            for (size_t k = literal == -1 ? 0 : 1; k < literals.size(); k++) visit(literals[k]);
+        } else {
+            visit(getLiteral(-2 - reason, false));
+            if (literal == -1) visit(conflictLiteral);
+        }
+
+        do {
+            index--;
+        } while (!seen[trail[index] >> 1]);
+        literal = trail[index];
+        seen[literal >> 1] = false;
+        if (--numAtLevel == 0) break;
+        reason = reasons[literal >> 1];
+    }
+    learned[0] = literal ^ 1;
+
+    minimize();
+    backjumpLevel = 0;
+    for (size_t k = 1; k < learned.size(); k++) {
+        if (levels[learned[k] >> 1] > backjumpLevel) {
+            backjumpLevel = levels[learned[k] >> 1];
+            swap(learned[1], learned[k]);
+        }
+    }
+}
+
+/**
+ * Method: minimize
+ * ----------------
+ * Drops each literal of the learned clause whose reason consists of
+ * nothing but other literals of the clause and literals from level 0,
+ * since the clause implies it anyway, and then clears the marks analyze
+ * left on the variables of the clause.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::minimize() {
+    size_t kept = 1, size = learned.size();
+    for (size_t k = 1; k < size; k++) {
+        int reason = reasons[learned[k] >> 1];
+        bool isImplied = reason != kNoReason;
+        if (reason >= 0) {
+            const vector<int>& literals = clauses[reason].literals;
+            for (size_t i = 1; i < literals.size() && isImplied; i++) {
+                int variable = literals[i] >> 1;
+                isImplied = seen[variable] || levels[variable] == 0;
+            }
+        } else if (reason != kNoReason) {
+            int variable = -2 - reason;
+            isImplied = seen[variable] || levels[variable] == 0;
+        }
+        if (!isImplied) learned[kept++] = learned[k];
+        else learned.push_back(learned[k]);
+    }
+
+    for (size_t k = 1; k < learned.size(); k++) seen[learned[k] >> 1] = false;
+    learned.resize(kept);
+}
+
+/**
+ * Method: backjump
+ * ----------------
+ * Undoes every assignment made above the provided level, saving each
+ * variable's value as the phase to try first when it's next decided.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::backjump(int level) {
+    if (getLevel() <= level) return;
+    for (size_t i = trail.size(); i-- > levelStarts[level];) {
+        int variable = trail[i] >> 1;
+        phases[variable] = values[variable];
+        values[variable] = -1;
+        reasons[variable] = kNoReason;
+        heapInsert(variable);
+    }
+    trail.resize(levelStarts[level]);
+    levelStarts.resize(level);
+    propagated = trail.size();
+}
+
+/**
+ * Method: learn
+ * -------------
+ * Adds the learned clause and asserts its first literal, which is the
+ * only one left unassigned after the backjump.  A clause of one literal is
+ * simply assigned at level 0 and never stored.  The span counts the level
+ * of the first literal as it was before the backjump.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::learn() {
+    if (learned.size() == 1) {
+        assign(learned[0], kNoReason);
+        return;
+    }
+
+    vector<int> spannedLevels;
+    for (int literal: learned) spannedLevels.push_back(levels[literal >> 1]);
+    sort(spannedLevels.begin(), spannedLevels.end());
+    int span = unique(spannedLevels.begin(), spannedLevels.end()) - spannedLevels.begin();
+
+    Clause clause = { learned, clauseBump, span };
+    clauses.push_back(clause);
+    attach(clauses.size() - 1);
+    assign(learned[0], clauses.size() - 1);
+}
+
+/**
+ * Implementation notes: reduce
+ * ----------------------------
+ * Deletes half of the learned clauses, those spanning the most levels
+ * first and the least active among clauses of equal span, sparing the ones
+ * spanning kKeptSpan levels or fewer and the ones that are the reasons for
+ * current assignments.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::reduce() {
+    vector<int> candidates;
+    for (size_t clause = numOriginal; clause < clauses.size(); clause++) {
+        if (clauses[clause].span > kKeptSpan && !isLocked(clause)) candidates.push_back(clause);
+    }
+    sort(candidates.begin(), candidates.end(), [this](int first, int second) {
+        if (clauses[first].span != clauses[second].span) return clauses[first].span > clauses[second].span;
+        return clauses[first].activity < clauses[second].activity;
+    });
+
+    vector<char> isDeleted(clauses.size(), false);
+    for (size_t i = 0; i < candidates.size() / 2; i++) isDeleted[candidates[i]] = true;
+    collectGarbage(isDeleted);
+}
+
+/**
+ * Method: collectGarbage
+ * ----------------------
+ * Removes the deleted clauses, renumbering the rest and the reasons that
+ * refer to them, and rebuilds the watch lists.  Each clause still watches
+ * its first two literals, so the watches stay valid.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::collectGarbage(const vector<char>& isDeleted) {
+    vector<int> renumbered(clauses.size(), -1);
+    size_t kept = 0;
+    for (size_t clause = 0; clause < clauses.size(); clause++) {
+        if (isDeleted[clause]) continue;
+        renumbered[clause] = kept;
+        if (kept != clause) clauses[kept] = move(clauses[clause]);
+        kept++;
+    }
+    clauses.resize(kept);
+
+    for (int literal: trail) {
+        int& reason = reasons[literal >> 1];
+        if (reason >= 0) reason = renumbered[reason];
+    }
+    for (vector<Watcher>& list: watches) list.clear();
+    for (size_t clause = 0; clause < clauses.size(); clause++) attach(clause);
+}
+
+template <int Order>
+void BasicSuDoKuCDCL<Order>::attach(int clause) {
+    const vector<int>& literals = clauses[clause].literals;
+    Watcher first = { clause, literals[1] }, second = { clause, literals[0] };
+    watches[literals[0]].push_back(first);
+    watches[literals[1]].push_back(second);
+}
+
+template <int Order>
+bool BasicSuDoKuCDCL<Order>::isLocked(int clause) const {
+    int literal = clauses[clause].literals[0];
+    return reasons[literal >> 1] == clause && values[literal >> 1] == ((literal & 1) == 0);
+}
+
+template <int Order>
+void BasicSuDoKuCDCL<Order>::bumpVariable(int variable) {
+    activities[variable] += variableBump;
+    if (activities[variable] > kRescaleLimit) {
+        for (double& activity: activities) activity /= kRescaleLimit;
+        variableBump /= kRescaleLimit;
+    }
+    if (heapIndices[variable] != -1) heapUp(heapIndices[variable]);
+}
+
+template <int Order>
+void BasicSuDoKuCDCL<Order>::bumpClause(int clause) {
+    if (size_t(clause) < numOriginal) return;
+    clauses[clause].activity += clauseBump;
+    if (clauses[clause].activity > kRescaleLimit) {
+        for (size_t other = numOriginal; other < clauses.size(); other++) {
+            clauses[other].activity /= kRescaleLimit;
+        }
+        clauseBump /= kRescaleLimit;
+    }
+}
+
+/**
+ * Method: chooseLiteral
+ * ---------------------
+ * Returns the saved phase of the most active unassigned variable, or -1 if
+ * every variable is assigned.  Variables assigned since they were last
+ * inserted into the heap are discarded as they surface.
+ */
+template <int Order>
+int BasicSuDoKuCDCL<Order>::chooseLiteral() {
+    while (!heap.empty()) {
+        int variable = heapPop();
+        if (values[variable] == -1) return getLiteral(variable, phases[variable]);
+    }
+    return -1;
+}
+
+/**
+ * Methods: heapInsert, heapPop, heapUp, heapDown
+ * ----------------------------------------------
+ * Maintain heap as a binary max-heap of variables ordered by activity,
+ * with heapIndices giving each variable's position, or -1 if it's not in
+ * the heap.
+ */
+template <int Order>
+void BasicSuDoKuCDCL<Order>::heapInsert(int variable) {
+    if (heapIndices[variable] != -1) return;
+    heapIndices[variable] = heap.size();
+    heap.push_back(variable);
+    heapUp(heap.size() - 1);
+}
+
+template <int Order>
+int BasicSuDoKuCDCL<Order>::heapPop() {
+    int top = heap[0];
+    heap[0] = heap.back();
+    heapIndices[heap[0]] = 0;
+    heap.pop_back();
+    heapIndices[top] = -1;
+    if (!heap.empty()) heapDown(0);
+    return top;
+}
+
+template <int Order>
+void BasicSuDoKuCDCL<Order>::heapUp(int index) {
+    int variable = heap[index];
+    while (index > 0 && activities[heap[(index - 1) / 2]] < activities[variable]) {
+        heap[index] = heap[(index - 1) / 2];
+        heapIndices[heap[index]] = index;
+        index = (index - 1) / 2;
+    }
+    heap[index] = variable;
+    heapIndices[variable] = index;
+}
+
+template <int Order>
+void BasicSuDoKuCDCL<Order>::heapDown(int index) {
+    int variable = heap[index], size = heap.size();
+    while (2 * index + 1 < size) {
+        int child = 2 * index + 1;
+        if (child + 1 < size && activities[heap[child + 1]] > activities[heap[child]]) child++;
+        if (activities[heap[child]] <= activities[variable]) break;
+        heap[index] = heap[child];
+        heapIndices[heap[index]] = index;
+        index = child;
+    }
+    heap[index] = variable;
+    heapIndices[variable] = index;
+}
+
+template class BasicSuDoKuCDCL<2>;
+template class BasicSuDoKuCDCL<3>;
+template class BasicSuDoKuCDCL<4>;
+template class BasicSuDoKuCDCL<5>;
+template class BasicSuDoKuCDCL<6>;
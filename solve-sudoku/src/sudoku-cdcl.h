@@ -0,0 +1,176 @@
+/**
+ * File: sudoku-cdcl.h
+ * -------------------
+ * Defines the BasicSuDoKuCDCL class template, which solves SuDoKu puzzles
+ * of any supported order as satisfiability problems, using conflict-driven
+ * clause learning rather than the chronological backtracking of
+ * sudoku-solver.h.  Backtracking forgets why each guess failed, so on
+ * 16 x 16 and larger boards it can make the same mistake in millions of
+ * places; clause learning remembers each mistake as a nogood and never
+ * makes it again.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "sudoku-board.h"
+#include "sudoku-constants.h"
+#include "sudoku-observers.h"
+
+/**
+ * Class: BasicSuDoKuCDCL
+ * ----------------------
+ * Encodes the board with one variable for each digit that could go in
+ * each location, true if the digit goes there.  Every location holds at
+ * least one digit, and every row, column, and block holds each digit at
+ * least once, which are clauses of kDimension literals each, propagated
+ * with two watched literals.  A digit placed anywhere rules itself out of
+ * the location's peers and every other digit out of the location; those
+ * binary clauses are far too many to list on the larger boards, so they're
+ * applied directly from a table of peers and never stored.
+ *
+ * The search is the standard one: decide on the unassigned variable with
+ * the highest activity, propagate, and on each conflict learn the clause
+ * at the first unique implication point, backjump to the second highest
+ * level in it, and bump the activity of the variables involved.  The
+ * search restarts after a number of conflicts that follows the Luby
+ * sequence, keeping its learned clauses and saved phases, and periodically
+ * deletes the less useful half of the learned clauses, judged by the
+ * number of decision levels they span, so memory stays bounded however
+ * long the search runs.  One BasicSuDoKuCDCL can solve any number of
+ * puzzles of its order, starting each from scratch.
+ */
+template <int Order>
+class BasicSuDoKuCDCL {
+public:
+    typedef BasicSuDoKuBoard<Order> Board;
+    static const int kDimension = Order * Order;
+
+    /**
+     * Constructor: BasicSuDoKuCDCL
+     * ----------------------------
+     * Builds the clauses and the table of peers shared by every puzzle.
+     */
+    BasicSuDoKuCDCL();
+
+    /**
+     * Method: solve
+     * -------------
+     * Behaves just like the solve function in sudoku-solver.h: returns true
+     * if and only if the puzzle on the board can be solved, in which case the
+     * solution is left within the board and presented in the display, and
+     * otherwise leaves the board and display as they were.  The display
+     * only sees the solution, since the search's assignments come and go
+     * too haphazardly to be worth animating.
+     */
+    bool solve(Board& board);
+    template <typename Display>
+    bool solve(Display& display, Board& board);
+
+    /**
+     * Methods: getNodeCount, getConflictCount, getRestartCount, getLearnedCount
+     * -------------------------------------------------------------------------
+     * Return the number of decisions, conflicts, and restarts during the
+     * most recent search, and the number of learned clauses it ended with.
+     */
+    uint64_t getNodeCount() const { return numDecisions; }
+    uint64_t getConflictCount() const { return numConflicts; }
+    uint64_t getRestartCount() const { return numRestarts; }
+    uint64_t getLearnedCount() const { return clauses.size() - numOriginal; }
+
+private:
+    static const int kNumCells = kDimension * kDimension;
+    static const int kNumVariables = kNumCells * kDimension;
+
+    struct Clause {
+        std::vector<int> literals;
+        double activity;
+        int span;                         // distinct decision levels, for learned clauses
+    };
+
+    struct Watcher {
+        int clause;
+        int blocker;                      // a literal whose truth satisfies the clause
+    };
+
+    std::vector<Clause> clauses;          // the original clauses, then the learned ones
+    size_t numOriginal;
+    std::vector<std::vector<Watcher> > watches; // by literal, the clauses watching it
+    std::vector<int> peers;               // kNumPeers locations per location
+
+    std::vector<signed char> values;      // by variable: 1 true, 0 false, -1 unassigned
+    std::vector<int> levels;
+    std::vector<int> reasons;
+    std::vector<char> phases;
+    std::vector<char> seen;
+    std::vector<int> trail;
+    std::vector<size_t> levelStarts;
+    size_t propagated;
+
+    std::vector<double> activities;
+    std::vector<int> heap;
+    std::vector<int> heapIndices;
+    double variableBump;
+    double clauseBump;
+
+    uint64_t numDecisions;
+    uint64_t numConflicts;
+    uint64_t numRestarts;
+    std::vector<int> learned;
+
+    bool search(const Board& board);
+    void reset();
+    void assign(int literal, int reason);
+    bool propagate(int& conflict, int& conflictLiteral);
+    void analyze(int conflict, int conflictLiteral, int& backjumpLevel);
+    void minimize();
+    void backjump(int level);
+    void learn();
+    void reduce();
+    void collectGarbage(const std::vector<char>& isDeleted);
+    void attach(int clause);
+    void bumpVariable(int variable);
+    void bumpClause(int clause);
+    int chooseLiteral();
+    void heapInsert(int variable);
+    int heapPop();
+    void heapUp(int index);
+    void heapDown(int index);
+    bool isLocked(int clause) const;
+    int getLevel() const { return levelStarts.size(); }
+
+    static int getVariable(int cell, int digit) { return cell * kDimension + digit - 1; }
+    static int getLiteral(int variable, bool isTrue) { return 2 * variable + (isTrue ? 0 : 1); }
+};
+
+/**
+ * Type: SuDoKuCDCL
+ * ----------------
+ * The clause learning solver for the classic 9 x 9 board.
+ */
+typedef BasicSuDoKuCDCL<kBoardOrder> SuDoKuCDCL;
+
+template <int Order>
+bool BasicSuDoKuCDCL<Order>::solve(Board& board) {
+    NullSuDoKuObserver observer;
+    return solve(observer, board);
+}
+
+template <int Order>
+template <typename Display>
+bool BasicSuDoKuCDCL<Order>::solve(Display& display, Board& board) {
+    if (!search(board)) return false;
+    for (int cell = 0; cell < kNumCells; cell++) {
+        int row = cell / kDimension, col = cell % kDimension;
+        if (board[row][col] != kEmpty) continue;
+        for (int digit = 1; digit <= kDimension; digit++) {
+            if (values[getVariable(cell, digit)] != 1) continue;
+            board[row][col] = digit;
+            display.provisionallyPlaceNumber(row, col, digit);
+            display.permanentlyPlaceNumber(row, col);
+            break;
+        }
+    }
+    return true;
+}
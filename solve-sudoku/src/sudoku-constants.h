@@ -2,15 +2,19 @@
  * File: sudoku-constants.h
  * ------------------------
  * Defines a collection of constants that need to be shared between
- * the model and the view of the SuDoKu solver.
+ * the model and the view of the SuDoKu solver.  The classic puzzle has
+ * order 3: its blocks are 3 x 3, so the board is 9 x 9 and uses 9 digits.
+ * The model also handles the other orders from kMinBoardOrder through
+ * kMaxBoardOrder, but the view only ever displays the classic puzzle.
  */
 
 #pragma once
 
 /* Constants */
-static const int kNumDigits = 9;
+static const int kBoardOrder = 3;
+static const int kNumDigits = kBoardOrder * kBoardOrder;
 static const int kBoardDimension = kNumDigits;
-static const int kBlockWidth = kNumDigits / 3;
+static const int kBlockWidth = kBoardOrder;
+static const int kMinBoardOrder = 2; // 4 x 4 boards
+static const int kMaxBoardOrder = 6; // 36 x 36 boards
 static const int kEmpty = 0; // sentinel in place to mean no number has been placed
-
-
@@ -0,0 +1,60 @@
+/**
+ * File: sudoku-exact-cover.cpp
+ * ----------------------------
+ * Presents the implementation of the methods of the BasicSuDoKuExactCover
+ * class template that don't depend on the display, instantiated here for
+ * every supported order.
+ */
+
+#include "sudoku-exact-cover.h"
+using namespace std;
+
+/**
+ * Implementation notes: constructor
+ * ---------------------------------
+ * The columns are laid out in four groups of kNumCells: the location
+ * (row, col), then the digit within the row, within the column, and within
+ * the block.  Rows are added in the order getRow numbers them.
+ */
+template <int Order>
+BasicSuDoKuExactCover<Order>::BasicSuDoKuExactCover() : matrix(4 * kDimension * kDimension) {
+    const int kNumCells = kDimension * kDimension;
+    vector<int> columns(4);
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            int block = row / Order * Order + col / Order;
+            for (int digit = 1; digit <= kDimension; digit++) {
+                columns[0] = row * kDimension + col;
+                columns[1] = kNumCells + row * kDimension + digit - 1;
+                columns[2] = 2 * kNumCells + col * kDimension + digit - 1;
+                columns[3] = 3 * kNumCells + block * kDimension + digit - 1;
+                matrix.addRow(columns);
+            }
+        }
+    }
+}
+
+/**
+ * Method: selectGivens
+ * --------------------
+ * Selects the row of every digit already on the board, returning false if
+ * two of them break the rules.
+ */
+template <int Order>
+bool BasicSuDoKuExactCover<Order>::selectGivens(const Board& board, int& numGivens) {
+    numGivens = 0;
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            if (board[row][col] == kEmpty) continue;
+            if (!matrix.selectRow(getRow(row, col, board[row][col]))) return false;
+            numGivens++;
+        }
+    }
+    return true;
+}
+
+template class BasicSuDoKuExactCover<2>;
+template class BasicSuDoKuExactCover<3>;
+template class BasicSuDoKuExactCover<4>;
+template class BasicSuDoKuExactCover<5>;
+template class BasicSuDoKuExactCover<6>;
@@ -0,0 +1,137 @@
+/**
+ * File: sudoku-exact-cover.h
+ * --------------------------
+ * Defines the BasicSuDoKuExactCover class template, which solves SuDoKu
+ * puzzles of any supported order by handing them to the dancing links
+ * search in exact-cover.h rather than to the backtracking search in
+ * sudoku-solver.h.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "exact-cover.h"
+#include "sudoku-board.h"
+#include "sudoku-constants.h"
+#include "sudoku-observers.h"
+
+/**
+ * Class: BasicSuDoKuExactCover
+ * ----------------------------
+ * Encodes SuDoKu as an exact cover problem with one row for each digit
+ * that could go in each location (729 rows in all for the classic board)
+ * and one column for each constraint (324 in all): every location holds a
+ * digit, and every row, column, and block holds each digit once.  The digit d at (row, col)
+ * covers exactly one column of each of the four kinds.  The matrix is built
+ * once, and each puzzle selects the rows of its given digits before the
+ * search, so one BasicSuDoKuExactCover can solve any number of puzzles of
+ * its order.
+ */
+template <int Order>
+class BasicSuDoKuExactCover {
+public:
+    typedef BasicSuDoKuBoard<Order> Board;
+    static const int kDimension = Order * Order;
+
+    /**
+     * Constructor: BasicSuDoKuExactCover
+     * ----------------------------------
+     * Builds the exact cover matrix shared by every puzzle.
+     */
+    BasicSuDoKuExactCover();
+
+    /**
+     * Method: solve
+     * -------------
+     * Behaves just like the solve function in sudoku-solver.h: returns true
+     * if and only if the puzzle on the board can be solved, in which case the
+     * solution is left within the board and presented in the display, and
+     * otherwise leaves the board and display as they were.
+     */
+    bool solve(Board& board);
+    template <typename Display>
+    bool solve(Display& display, Board& board);
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of digits placed during the most recent search.
+     */
+    uint64_t getNodeCount() const { return matrix.getNodeCount(); }
+
+private:
+    ExactCover matrix;
+
+    bool selectGivens(const Board& board, int& numGivens);
+
+    static int getRow(int row, int col, int digit) {
+        return (row * kDimension + col) * kDimension + digit - 1;
+    }
+};
+
+/**
+ * Type: SuDoKuExactCover
+ * ----------------------
+ * The exact cover solver for the classic 9 x 9 board.
+ */
+typedef BasicSuDoKuExactCover<kBoardOrder> SuDoKuExactCover;
+
+/**
+ * Class: SuDoKuCoverVisitor
+ * -------------------------
+ * Translates the rows chosen by the exact cover search into digits placed
+ * on the board and reported to the display.
+ */
+template <typename Display, int Order>
+class SuDoKuCoverVisitor {
+public:
+    static const int kDimension = Order * Order;
+
+    SuDoKuCoverVisitor(Display& display, BasicSuDoKuBoard<Order>& board, int numGivens) :
+        display(display), board(board), numGivens(numGivens) {}
+
+    void chooseRow(int row) {
+        int digit = row % kDimension + 1, cell = row / kDimension;
+        board[cell / kDimension][cell % kDimension] = digit;
+        display.provisionallyPlaceNumber(cell / kDimension, cell % kDimension, digit);
+    }
+
+    void unchooseRow(int row) {
+        int cell = row / kDimension;
+        board[cell / kDimension][cell % kDimension] = kEmpty;
+        display.liftNumber(cell / kDimension, cell % kDimension);
+    }
+
+    bool reportSolution(const std::vector<int>& rows) {
+        for (size_t i = numGivens; i < rows.size(); i++) {
+            int cell = rows[i] / kDimension;
+            display.permanentlyPlaceNumber(cell / kDimension, cell % kDimension);
+        }
+        return false;
+    }
+
+private:
+    Display& display;
+    BasicSuDoKuBoard<Order>& board;
+    size_t numGivens;
+};
+
+template <int Order>
+bool BasicSuDoKuExactCover<Order>::solve(Board& board) {
+    NullSuDoKuObserver observer;
+    return solve(observer, board);
+}
+
+template <int Order>
+template <typename Display>
+bool BasicSuDoKuExactCover<Order>::solve(Display& display, Board& board) {
+    int numGivens;
+    bool solved = false;
+    if (selectGivens(board, numGivens)) {
+        SuDoKuCoverVisitor<Display, Order> visitor(display, board, numGivens);
+        solved = matrix.solve(visitor) > 0;
+    }
+    matrix.clearSelection();
+    return solved;
+}
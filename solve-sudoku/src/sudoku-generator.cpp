@@ -0,0 +1,179 @@
+/**
+ * File: sudoku-generator.cpp
+ * --------------------------
+ * Presents the implementation of the SuDoKuGenerator class and the
+ * functions that rate and mass-produce puzzles.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "sudoku-generator.h"
+#include "sudoku-observers.h"
+#include "sudoku-solver.h"
+using namespace std;
+
+/* Constants */
+static const uint64_t kGeneratorBlockSize = 16; // puzzles claimed by a thread at a time
+
+const char *getDifficultyName(SuDoKuDifficulty difficulty) {
+    switch (difficulty) {
+        case kEasyPuzzle: return "easy";
+        case kMediumPuzzle: return "medium";
+        default: return "hard";
+    }
+}
+
+/**
+ * Implementation notes: ratePuzzle
+ * --------------------------------
+ * Propagates with singles alone, and then with locked candidates too,
+ * stopping as soon as the board fills up.  Nothing is ever guessed, and
+ * propagation only ever narrows the options, so the second round picks up
+ * where the first left off.  The number of nodes comes from a separate,
+ * observed run of the full search.
+ */
+SuDoKuRating ratePuzzle(const SuDoKuBoard& puzzle) {
+    SuDoKuRating rating;
+    SuDoKuBoard board = puzzle;
+    SuDoKuCandidates candidates(board);
+    vector<SuDoKuChange> trail;
+    NullSuDoKuObserver observer;
+    int row, col;
+    if (propagate(observer, board, candidates, trail, false) && !findLocation(board, candidates, row, col)) {
+        rating.difficulty = kEasyPuzzle;
+    } else if (propagate(observer, board, candidates, trail, true) && !findLocation(board, candidates, row, col)) {
+        rating.difficulty = kMediumPuzzle;
+    } else {
+        rating.difficulty = kHardPuzzle;
+    }
+
+    CountingSuDoKuObserver counter;
+    board = puzzle;
+    solve(counter, board);
+    rating.numNodes = counter.numPlaced;
+    return rating;
+}
+
+SuDoKuGenerator::SuDoKuGenerator(uint64_t seed) : random(seed) {}
+
+void SuDoKuGenerator::reseed(uint64_t seed, uint64_t stream) {
+    seed_seq sequence = { uint32_t(seed), uint32_t(seed >> 32), uint32_t(stream), uint32_t(stream >> 32) };
+    random.seed(sequence);
+}
+
+void SuDoKuGenerator::generateGrid(SuDoKuBoard& grid) {
+    grid = SuDoKuBoard();
+    int digits[kNumDigits];
+    for (int i = 0; i < kNumDigits; i++) {
+        digits[i] = i + 1;
+    }
+    for (int block = 0; block < kBlockWidth; block++) {
+        shuffle(digits, digits + kNumDigits, random);
+        for (int i = 0; i < kNumDigits; i++) {
+            grid[block * kBlockWidth + i / kBlockWidth][block * kBlockWidth + i % kBlockWidth] = digits[i];
+        }
+    }
+    solve(grid);
+}
+
+void SuDoKuGenerator::removeClues(SuDoKuBoard& puzzle) {
+    int cells[kBoardDimension * kBoardDimension];
+    for (int cell = 0; cell < kBoardDimension * kBoardDimension; cell++) {
+        cells[cell] = cell;
+    }
+    shuffle(cells, cells + kBoardDimension * kBoardDimension, random);
+
+    NullSuDoKuObserver observer;
+    vector<SuDoKuChange> trail;
+    for (int cell: cells) {
+        int row = cell / kBoardDimension, col = cell % kBoardDimension, digit = puzzle[row][col];
+        if (digit == kEmpty) continue;
+        puzzle[row][col] = kEmpty;
+        SuDoKuBoard board = puzzle;
+        SuDoKuCandidates candidates(board);
+        candidates.setExcluded(row, col, SuDoKuCandidates::getMask(digit));
+        trail.clear();
+        if (solve(observer, board, candidates, trail)) puzzle[row][col] = digit;
+    }
+}
+
+void SuDoKuGenerator::generatePuzzle(SuDoKuBoard& puzzle) {
+    generateGrid(puzzle);
+    removeClues(puzzle);
+}
+
+/**
+ * Function: countClues
+ * --------------------
+ * Returns the number of occupied locations on the board.
+ */
+static int countClues(const SuDoKuBoard& board) {
+    int numClues = 0;
+    for (int row = 0; row < kBoardDimension; row++) {
+        for (int col = 0; col < kBoardDimension; col++) {
+            if (board[row][col] != kEmpty) numClues++;
+        }
+    }
+    return numClues;
+}
+
+/**
+ * Implementation notes: generatePuzzles
+ * -------------------------------------
+ * Works the way SuDoKuBatchSolver does: the threads claim blocks of
+ * kGeneratorBlockSize puzzles from an atomic counter, build each block's
+ * output in memory, and hand it to a reorder buffer that writes the blocks
+ * in order.  Every thread has its own generator, reseeded for each puzzle,
+ * and publishes its search statistics, if they're compiled in, when done.
+ */
+void generatePuzzles(uint64_t numPuzzles, uint64_t seed, int numThreads, ostream& out) {
+    if (numThreads <= 0) numThreads = max(1, (int) thread::hardware_concurrency());
+    uint64_t numBlocks = (numPuzzles + kGeneratorBlockSize - 1) / kGeneratorBlockSize;
+    atomic<uint64_t> nextBlock(0);
+    mutex outputLock;
+    vector<string> results(numBlocks);
+    vector<char> isFinished(numBlocks, false);
+    uint64_t nextToWrite = 0;
+
+    auto work = [&]() {
+        SuDoKuGenerator generator;
+        SuDoKuBoard puzzle;
+        string output;
+        for (uint64_t block = nextBlock++; block < numBlocks; block = nextBlock++) {
+            uint64_t end = min(numPuzzles, (block + 1) * kGeneratorBlockSize);
+            for (uint64_t index = block * kGeneratorBlockSize; index < end; index++) {
+                generator.reseed(seed, index);
+                generator.generatePuzzle(puzzle);
+                SuDoKuRating rating = ratePuzzle(puzzle);
+                output += puzzle.toString();
+                output += ' ';
+                output += getDifficultyName(rating.difficulty);
+                output += ' ' + to_string(countClues(puzzle)) + ' ' + to_string(rating.numNodes) + '\n';
+            }
+
+            lock_guard<mutex> guard(outputLock);
+            results[block].swap(output);
+            isFinished[block] = true;
+            while (nextToWrite < numBlocks && isFinished[nextToWrite]) {
+                out.write(results[nextToWrite].data(), results[nextToWrite].size());
+                string().swap(results[nextToWrite]);
+                nextToWrite++;
+            }
+        }
+        SUDOKU_STATS(publishSuDoKuStats());
+    };
+
+    vector<thread> workers;
+    for (int i = 1; i < min<uint64_t>(numThreads, numBlocks); i++) {
+        workers.push_back(thread(work));
+    }
+    work();
+    for (thread& worker: workers) {
+        worker.join();
+    }
+    out.flush();
+}
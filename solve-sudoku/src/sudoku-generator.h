@@ -0,0 +1,123 @@
+/**
+ * File: sudoku-generator.h
+ * ------------------------
+ * Defines the SuDoKuGenerator class, which makes new SuDoKu puzzles with
+ * unique solutions and rates how hard they are, and generatePuzzles, which
+ * runs one generator per thread to make them in bulk.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include "sudoku-board.h"
+
+/**
+ * Type: SuDoKuDifficulty
+ * ----------------------
+ * Rates a puzzle by the hardest technique needed to solve it: singles
+ * alone (naked and hidden), locked candidates as well, or guessing.
+ */
+enum SuDoKuDifficulty {
+    kEasyPuzzle,
+    kMediumPuzzle,
+    kHardPuzzle
+};
+
+/**
+ * Type: SuDoKuRating
+ * ------------------
+ * Pairs a puzzle's difficulty with the number of numbers the search placed
+ * while solving it, which tells apart puzzles of the same difficulty.
+ */
+struct SuDoKuRating {
+    SuDoKuDifficulty difficulty;
+    uint64_t numNodes;
+};
+
+/**
+ * Function: getDifficultyName
+ * ---------------------------
+ * Returns "easy", "medium", or "hard".
+ */
+const char *getDifficultyName(SuDoKuDifficulty difficulty);
+
+/**
+ * Function: ratePuzzle
+ * --------------------
+ * Rates the puzzle, which should have a unique solution.
+ */
+SuDoKuRating ratePuzzle(const SuDoKuBoard& puzzle);
+
+/**
+ * Class: SuDoKuGenerator
+ * ----------------------
+ * Generates puzzles by filling a grid at random and then removing clues
+ * in random order, keeping each one whose removal would leave the puzzle
+ * with more than one solution, so every puzzle it makes is minimal as well
+ * as unique.  Each generator draws from its own random number engine, so
+ * any number of them can run at once, one per thread.
+ */
+class SuDoKuGenerator {
+public:
+
+    /**
+     * Constructor: SuDoKuGenerator
+     * ----------------------------
+     * Constructs a generator whose engine is seeded with the provided seed.
+     */
+    SuDoKuGenerator(uint64_t seed = 1);
+
+    /**
+     * Method: reseed
+     * --------------
+     * Reseeds the engine from the seed and the stream, so that the puzzle
+     * generated next depends on nothing else.  generatePuzzles uses the
+     * index of each puzzle as its stream, so that its output doesn't depend
+     * on which thread generated which puzzle.
+     */
+    void reseed(uint64_t seed, uint64_t stream);
+
+    /**
+     * Method: generateGrid
+     * --------------------
+     * Fills the board with a random solution.  The three blocks on the
+     * diagonal share no row, column, or block, so they're filled with
+     * random permutations of the digits, and the search fills in the rest.
+     */
+    void generateGrid(SuDoKuBoard& grid);
+
+    /**
+     * Method: removeClues
+     * -------------------
+     * Removes clues from the board, which must have a unique solution, in
+     * random order, for as long as the solution stays unique.  A clue can
+     * go unless the puzzle without it can be solved with some other digit
+     * in its place, which is one search rather than a count of solutions.
+     */
+    void removeClues(SuDoKuBoard& puzzle);
+
+    /**
+     * Method: generatePuzzle
+     * ----------------------
+     * Fills the board with a new puzzle, generating a grid and then
+     * removing clues from it.
+     */
+    void generatePuzzle(SuDoKuBoard& puzzle);
+
+private:
+    std::mt19937_64 random;
+};
+
+/**
+ * Function: generatePuzzles
+ * -------------------------
+ * Generates numPuzzles puzzles on numThreads threads (one per hardware
+ * thread if numThreads is 0) and writes one line per puzzle to out: the
+ * puzzle, with '0' for empty cells, then its difficulty, number of clues,
+ * and number of search nodes.  Puzzle i is generated from the seed and i
+ * alone, and the puzzles are written in order, so the output is the same
+ * whatever the number of threads.
+ */
+void generatePuzzles(uint64_t numPuzzles, uint64_t seed, int numThreads, std::ostream& out);
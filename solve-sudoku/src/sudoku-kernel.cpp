@@ -0,0 +1,372 @@
+/**
+ * File: sudoku-kernel.cpp
+ * -----------------------
+ * Presents the implementation of the SuDoKuKernel class.  The AVX2 engine
+ * holds row r of the board in register r, with the location (r, c) in the
+ * 16-bit lane 4 * (c / 3) + c % 3, so that the three locations a row shares
+ * with each block fill one 64-bit quarter of the register (a quad), and the
+ * fourth quad and the last lane of the others are left empty.  A location's
+ * lane holds its candidates, with bit d - 1 set for digit d, and a location
+ * with one candidate left is solved.  Every unit is then summarized by the
+ * digits that are candidates in at least one of its locations and in at
+ * least two: within a quad by shuffling 16-bit lanes, across a row by
+ * permuting quads, down the columns by combining the nine registers lane
+ * by lane, and across a block by combining the quads of three rows.
+ */
+
+#include <cstring>
+#include "sudoku-kernel.h"
+#include "sudoku-observers.h"
+#include "sudoku-solver.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SUDOKU_HAVE_AVX2_KERNEL
+#endif
+using namespace std;
+
+/* Constants */
+static const int kLanesPerRow = 16;                          // 16-bit lanes in an AVX2 register
+static const int kStateSize = kBoardDimension * kLanesPerRow; // lanes in one board
+static const int kMaxGuesses = kBoardDimension * kBoardDimension;
+static const uint16_t kAllCandidates = (1 << kNumDigits) - 1;
+
+/**
+ * Function: getLane
+ * -----------------
+ * Returns the lane that holds the provided column.
+ */
+static inline int getLane(int col) {
+    return col / kBlockWidth * 4 + col % kBlockWidth;
+}
+
+SuDoKuKernel::SuDoKuKernel(SuDoKuKernelEngine engine) : engine(engine), numNodes(0) {
+    if (this->engine == kBestKernel) this->engine = isEngineSupported(kAVX2Kernel) ? kAVX2Kernel : kScalarKernel;
+    if (!isEngineSupported(this->engine)) this->engine = kScalarKernel;
+    if (this->engine == kAVX2Kernel) states.resize((kMaxGuesses + 1) * kStateSize);
+}
+
+bool SuDoKuKernel::isEngineSupported(SuDoKuKernelEngine engine) {
+    switch (engine) {
+    case kBestKernel:
+    case kScalarKernel:
+        return true;
+    case kAVX2Kernel:
+#ifdef SUDOKU_HAVE_AVX2_KERNEL
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char *SuDoKuKernel::getEngineName(SuDoKuKernelEngine engine) {
+    switch (engine) {
+    case kBestKernel: return "best";
+    case kScalarKernel: return "scalar";
+    case kAVX2Kernel: return "avx2";
+    }
+    return "unknown";
+}
+
+bool SuDoKuKernel::solve(SuDoKuBoard& board) {
+    numNodes = 0;
+    if (engine == kAVX2Kernel) return solveWithAVX2(board);
+    return solveWithScalar(board);
+}
+
+/**
+ * Method: solveWithScalar
+ * -----------------------
+ * Runs the search solve runs, but drives the Backtracker directly so that
+ * its node count, which is the number of guesses, can be reported.
+ */
+bool SuDoKuKernel::solveWithScalar(SuDoKuBoard& board) {
+    typedef SuDoKuProblem<NullSuDoKuObserver, kBoardOrder> Problem;
+    SuDoKuCandidates candidates(board);
+    if (!candidates.isConsistent()) return false;
+    NullSuDoKuObserver display;
+    SuDoKuStrategy strategy;
+    vector<SuDoKuChange> trail;
+    Problem problem(display, board, candidates, strategy);
+    Backtracker<Problem, SuDoKuSearchObserver> search(problem, trail);
+    bool solved = search.findFirst();
+    numNodes = search.getNodeCount();
+    return solved;
+}
+
+#ifdef SUDOKU_HAVE_AVX2_KERNEL
+
+/**
+ * Function: shuffleQuads
+ * ----------------------
+ * Rearranges the four lanes within every quad as Pattern directs.
+ */
+template <int Pattern>
+__attribute__((target("avx2")))
+static inline __m256i shuffleQuads(__m256i values) {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(values, Pattern), Pattern);
+}
+
+/**
+ * Function: mergeSummaries
+ * ------------------------
+ * Folds the summary of some locations (the digits that are candidates in
+ * at least one of them and in at least two) into the summary of others.
+ */
+__attribute__((target("avx2")))
+static inline void mergeSummaries(__m256i& once, __m256i& twice, __m256i otherOnce, __m256i otherTwice) {
+    twice = _mm256_or_si256(_mm256_or_si256(twice, otherTwice), _mm256_and_si256(once, otherOnce));
+    once = _mm256_or_si256(once, otherOnce);
+}
+
+/**
+ * Type: UnitSummary
+ * -----------------
+ * Summarizes every unit of the board.  The summaries of row r fill every
+ * lane of rowOnce[r] and rowTwice[r], the summaries of the columns sit in
+ * the columns' lanes of colOnce and colTwice, and the summaries of the
+ * blocks in band b (the three blocks that cover rows 3b through 3b + 2)
+ * fill the quads of boxOnce[b] and boxTwice[b] that hold their columns.
+ */
+struct UnitSummary {
+    __m256i rowOnce[kBoardDimension];
+    __m256i rowTwice[kBoardDimension];
+    __m256i colOnce;
+    __m256i colTwice;
+    __m256i boxOnce[kBlockWidth];
+    __m256i boxTwice[kBlockWidth];
+};
+
+/**
+ * Function: summarizeUnits
+ * ------------------------
+ * Summarizes the units of the board held in the nine registers.
+ */
+__attribute__((target("avx2")))
+static inline void summarizeUnits(const __m256i *rows, UnitSummary& summary) {
+    const __m256i zero = _mm256_setzero_si256();
+    summary.colOnce = summary.colTwice = zero;
+    for (int band = 0; band < kBlockWidth; band++) {
+        __m256i boxOnce = zero, boxTwice = zero;
+        for (int row = band * kBlockWidth; row < (band + 1) * kBlockWidth; row++) {
+            mergeSummaries(summary.colOnce, summary.colTwice, rows[row], zero);
+            __m256i once = rows[row], twice = zero;
+            mergeSummaries(once, twice, shuffleQuads<0xb1>(once), shuffleQuads<0xb1>(twice));
+            mergeSummaries(once, twice, shuffleQuads<0x4e>(once), shuffleQuads<0x4e>(twice));
+            mergeSummaries(boxOnce, boxTwice, once, twice);
+            mergeSummaries(once, twice, _mm256_permute4x64_epi64(once, 0x4e), _mm256_permute4x64_epi64(twice, 0x4e));
+            mergeSummaries(once, twice, _mm256_permute4x64_epi64(once, 0xb1), _mm256_permute4x64_epi64(twice, 0xb1));
+            summary.rowOnce[row] = once;
+            summary.rowTwice[row] = twice;
+        }
+        summary.boxOnce[band] = boxOnce;
+        summary.boxTwice[band] = boxTwice;
+    }
+}
+
+/**
+ * Function: keepHidden
+ * --------------------
+ * Narrows each location that holds one of the hidden digits (candidates
+ * in only one location of some unit) down to those digits.
+ */
+__attribute__((target("avx2")))
+static inline __m256i keepHidden(__m256i candidates, __m256i hidden) {
+    __m256i kept = _mm256_and_si256(candidates, hidden);
+    return _mm256_blendv_epi8(kept, candidates, _mm256_cmpeq_epi16(kept, _mm256_setzero_si256()));
+}
+
+/**
+ * Function: propagateSingles
+ * --------------------------
+ * Applies naked and hidden singles to the board held in the nine registers
+ * until nothing changes, returning false if the board reaches a
+ * contradiction.  A solved location's digit is ruled out of every other
+ * location in its units, and a solved location whose digit is also solved
+ * elsewhere in one of its units loses its digit, which is caught as a
+ * location with no candidates.  A unit where some digit is a candidate
+ * nowhere is a contradiction too.
+ */
+__attribute__((target("avx2")))
+static bool propagateSingles(__m256i *rows) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i allCandidates = _mm256_set1_epi16(kAllCandidates);
+    const __m256i realLanes = _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, 0, 0, 0, 0);
+    const __m256i emptyLaneCandidates = _mm256_andnot_si256(realLanes, allCandidates);
+    UnitSummary summary;
+    __m256i solved[kBoardDimension], isSolved[kBoardDimension];
+    while (true) {
+        for (int row = 0; row < kBoardDimension; row++) {
+            isSolved[row] = _mm256_cmpeq_epi16(_mm256_and_si256(rows[row], _mm256_sub_epi16(rows[row], one)), zero);
+            solved[row] = _mm256_and_si256(rows[row], isSolved[row]);
+        }
+        summarizeUnits(solved, summary);
+
+        __m256i changed = zero;
+        for (int row = 0; row < kBoardDimension; row++) {
+            int band = row / kBlockWidth;
+            __m256i once = _mm256_or_si256(_mm256_or_si256(summary.rowOnce[row], summary.colOnce),
+                                           summary.boxOnce[band]);
+            __m256i twice = _mm256_or_si256(_mm256_or_si256(summary.rowTwice[row], summary.colTwice),
+                                            summary.boxTwice[band]);
+            __m256i next = _mm256_andnot_si256(_mm256_blendv_epi8(once, twice, isSolved[row]), rows[row]);
+            changed = _mm256_or_si256(changed, _mm256_xor_si256(next, rows[row]));
+            rows[row] = next;
+        }
+
+        summarizeUnits(rows, summary);
+        __m256i covered = _mm256_or_si256(summary.colOnce, emptyLaneCandidates);
+        __m256i empty = zero;
+        for (int row = 0; row < kBoardDimension; row++) {
+            int band = row / kBlockWidth;
+            covered = _mm256_and_si256(covered, summary.rowOnce[row]);
+            covered = _mm256_and_si256(covered, _mm256_or_si256(summary.boxOnce[band], emptyLaneCandidates));
+            __m256i next = rows[row];
+            next = keepHidden(next, _mm256_andnot_si256(summary.rowTwice[row], summary.rowOnce[row]));
+            next = keepHidden(next, _mm256_andnot_si256(summary.colTwice, summary.colOnce));
+            next = keepHidden(next, _mm256_andnot_si256(summary.boxTwice[band], summary.boxOnce[band]));
+            changed = _mm256_or_si256(changed, _mm256_xor_si256(next, rows[row]));
+            empty = _mm256_or_si256(empty, _mm256_cmpeq_epi16(next, zero));
+            rows[row] = next;
+        }
+
+        if (!_mm256_testz_si256(empty, realLanes)) return false;
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(covered, allCandidates)) != -1) return false;
+        if (_mm256_testz_si256(changed, changed)) return true;
+    }
+}
+
+/**
+ * Function: countCandidates
+ * -------------------------
+ * Counts the candidates in each lane, by looking up the count for every
+ * nibble in a 16-entry table and summing the bytes of each lane.
+ */
+__attribute__((target("avx2")))
+static inline __m256i countCandidates(__m256i values) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbles = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(values, nibbles));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(values, 4), nibbles));
+    __m256i bytes = _mm256_add_epi8(low, high);
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xff)), _mm256_srli_epi16(bytes, 8));
+}
+
+/**
+ * Function: findGuess
+ * -------------------
+ * Finds the unsolved location with the fewest candidates, returning false
+ * if every location is solved.  Solved locations and empty lanes are given
+ * a count larger than any real one, so the smallest count can be found
+ * with unsigned minimums alone.
+ */
+__attribute__((target("avx2")))
+static bool findGuess(const __m256i *rows, int& row, int& lane) {
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i realLanes = _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, 0, 0, 0, 0);
+    __m256i counts[kBoardDimension];
+    __m256i smallest = _mm256_set1_epi16(-1);
+    for (int r = 0; r < kBoardDimension; r++) {
+        __m256i count = countCandidates(rows[r]);
+        __m256i ignored = _mm256_or_si256(_mm256_cmpeq_epi16(count, one),
+                                          _mm256_andnot_si256(realLanes, _mm256_set1_epi16(-1)));
+        counts[r] = _mm256_or_si256(count, ignored);
+        smallest = _mm256_min_epu16(smallest, counts[r]);
+    }
+
+    __m128i halves = _mm_min_epu16(_mm256_castsi256_si128(smallest), _mm256_extracti128_si256(smallest, 1));
+    int fewest = _mm_extract_epi16(_mm_minpos_epu16(halves), 0);
+    if (fewest == 0xffff) return false;
+    __m256i target = _mm256_set1_epi16(fewest);
+    for (row = 0; row < kBoardDimension; row++) {
+        unsigned matches = _mm256_movemask_epi8(_mm256_cmpeq_epi16(counts[row], target));
+        if (matches != 0) {
+            lane = __builtin_ctz(matches) / 2;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function: examineState
+ * ----------------------
+ * Propagates the board stored in state, writing the result back, and
+ * reports what's left to do: -1 if the board has reached a contradiction,
+ * 0 if it's solved, and 1 if a guess is needed, in which case row and lane
+ * identify the location to guess at.
+ */
+__attribute__((target("avx2")))
+static int examineState(uint16_t *state, int& row, int& lane) {
+    __m256i rows[kBoardDimension];
+    for (int r = 0; r < kBoardDimension; r++) {
+        rows[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state + r * kLanesPerRow));
+    }
+    bool isConsistent = propagateSingles(rows);
+    for (int r = 0; r < kBoardDimension; r++) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(state + r * kLanesPerRow), rows[r]);
+    }
+    if (!isConsistent) return -1;
+    return findGuess(rows, row, lane) ? 1 : 0;
+}
+
+/**
+ * Implementation notes: solveWithAVX2
+ * -----------------------------------
+ * states[depth] holds the board after depth guesses.  A guess copies the
+ * board one level up with the guessed digit placed, and rules the digit
+ * out of the board it was copied from, so that when the guess leads to a
+ * contradiction, dropping back a level leaves exactly the board to try
+ * next.  Every guess solves at least one more location, so there can be
+ * no more than kMaxGuesses of them in progress.
+ */
+bool SuDoKuKernel::solveWithAVX2(SuDoKuBoard& board) {
+    uint16_t *state = &states[0];
+    memset(state, 0, kStateSize * sizeof(uint16_t));
+    for (int row = 0; row < kBoardDimension; row++) {
+        for (int col = 0; col < kBoardDimension; col++) {
+            int digit = board[row][col];
+            state[row * kLanesPerRow + getLane(col)] = digit == kEmpty ? kAllCandidates : 1 << (digit - 1);
+        }
+    }
+
+    int depth = 0;
+    while (true) {
+        state = &states[depth * kStateSize];
+        int row, lane;
+        int status = examineState(state, row, lane);
+        if (status < 0) {
+            if (depth == 0) return false;
+            depth--;
+        } else if (status == 0) {
+            break;
+        } else {
+            uint16_t& candidates = state[row * kLanesPerRow + lane];
+            uint16_t guess = candidates & -candidates;
+            uint16_t *next = state + kStateSize;
+            memcpy(next, state, kStateSize * sizeof(uint16_t));
+            next[row * kLanesPerRow + lane] = guess;
+            candidates &= ~guess;
+            depth++;
+            numNodes++;
+        }
+    }
+
+    for (int row = 0; row < kBoardDimension; row++) {
+        for (int col = 0; col < kBoardDimension; col++) {
+            board[row][col] = __builtin_ctz(state[row * kLanesPerRow + getLane(col)]) + 1;
+        }
+    }
+    return true;
+}
+
+#else
+
+bool SuDoKuKernel::solveWithAVX2(SuDoKuBoard& board) {
+    return solveWithScalar(board);
+}
+
+#endif
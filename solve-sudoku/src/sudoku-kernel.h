@@ -0,0 +1,97 @@
+/**
+ * File: sudoku-kernel.h
+ * ---------------------
+ * Defines the SuDoKuKernel class, which solves classic 9 x 9 puzzles as
+ * quickly as possible by keeping the whole board in SIMD registers.  Each
+ * row is held in one 256-bit register as 16-bit masks of candidates, and
+ * every step of propagation applies to all 81 locations with the same
+ * handful of shuffles, compares, and bitwise operations, rather than
+ * looping over units and locations the way sudoku-solver.cpp does.
+ * Processors without the vector instructions use the search in
+ * sudoku-solver.h instead.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "sudoku-board.h"
+
+/**
+ * Type: SuDoKuKernelEngine
+ * ------------------------
+ * Identifies the instructions used to solve puzzles.  kScalarKernel runs on
+ * any processor, using the ordinary search in sudoku-solver.h, and
+ * kAVX2Kernel uses AVX2 vector instructions, which only some x86 processors
+ * support.  kBestKernel picks the fastest engine the processor supports.
+ */
+enum SuDoKuKernelEngine {
+    kBestKernel,
+    kScalarKernel,
+    kAVX2Kernel
+};
+
+/**
+ * Class: SuDoKuKernel
+ * -------------------
+ * Solves 9 x 9 puzzles with the provided engine.  The AVX2 engine
+ * propagates naked and hidden singles until nothing changes, then guesses
+ * the lowest candidate of a location with the fewest, and if that leads
+ * nowhere, rules the candidate out and carries on.  Each guess copies the
+ * board (nine registers) onto a stack instead of recording a trail of
+ * changes, since copying is cheaper than undoing at this size.
+ */
+class SuDoKuKernel {
+public:
+
+    /**
+     * Constructor: SuDoKuKernel
+     * -------------------------
+     * Constructs a kernel that solves puzzles with the provided engine.  If
+     * the processor doesn't support that engine, kScalarKernel is used
+     * instead.
+     */
+    SuDoKuKernel(SuDoKuKernelEngine engine = kBestKernel);
+
+    /**
+     * Method: solve
+     * -------------
+     * Behaves just like the solve function in sudoku-solver.h: returns true
+     * if and only if the puzzle on the board can be solved, in which case the
+     * solution is left within the board, and otherwise leaves the board as
+     * it was.
+     */
+    bool solve(SuDoKuBoard& board);
+
+    /**
+     * Method: getNodeCount
+     * --------------------
+     * Returns the number of guesses made during the most recent search,
+     * whichever engine made them.
+     */
+    uint64_t getNodeCount() const { return numNodes; }
+
+    /**
+     * Method: getEngine
+     * -----------------
+     * Returns the engine actually in use.
+     */
+    SuDoKuKernelEngine getEngine() const { return engine; }
+
+    /**
+     * Methods: isEngineSupported, getEngineName
+     * -----------------------------------------
+     * Report whether the processor supports the provided engine, and the
+     * engine's name.
+     */
+    static bool isEngineSupported(SuDoKuKernelEngine engine);
+    static const char *getEngineName(SuDoKuKernelEngine engine);
+
+private:
+    SuDoKuKernelEngine engine;
+    uint64_t numNodes;
+    std::vector<uint16_t> states;     // the stack of boards, one per guess in progress
+
+    bool solveWithAVX2(SuDoKuBoard& board);
+    bool solveWithScalar(SuDoKuBoard& board);
+};
@@ -0,0 +1,44 @@
+/**
+ * File: sudoku-observers.h
+ * ------------------------
+ * Defines the observers that can stand in for a SuDoKuDisplay when the
+ * search is run without animation.  solve is templated on the type of its
+ * observer, and any class with the three methods below (SuDoKuDisplay
+ * included) will do.  Because the calls are resolved at compile time, the
+ * empty methods of NullSuDoKuObserver compile away to nothing.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Class: NullSuDoKuObserver
+ * -------------------------
+ * Ignores everything the search reports.
+ */
+class NullSuDoKuObserver {
+public:
+    void provisionallyPlaceNumber(int, int, int) {}
+    void permanentlyPlaceNumber(int, int) {}
+    void liftNumber(int, int) {}
+};
+
+/**
+ * Class: CountingSuDoKuObserver
+ * -----------------------------
+ * Tallies everything the search reports, so that the size of the search
+ * can be reported without animating it.
+ */
+class CountingSuDoKuObserver {
+public:
+    CountingSuDoKuObserver() : numPlaced(0), numKept(0), numLifted(0) {}
+
+    void provisionallyPlaceNumber(int, int, int) { numPlaced++; }
+    void permanentlyPlaceNumber(int, int) { numKept++; }
+    void liftNumber(int, int) { numLifted++; }
+
+    uint64_t numPlaced; // numbers provisionally placed (nodes of the search tree)
+    uint64_t numKept;   // numbers that ended up in the solution
+    uint64_t numLifted; // numbers taken back (backtracks)
+};
@@ -0,0 +1,331 @@
+/**
+ * File: sudoku-rules.cpp
+ * ----------------------
+ * Presents the implementation of the BasicSuDoKuRules class template,
+ * instantiated at the bottom of the file for every supported order.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+#include "sudoku-rules.h"
+using namespace std;
+
+template <int Order>
+const BasicSuDoKuRules<Order>& BasicSuDoKuRules<Order>::getClassic() {
+    static const BasicSuDoKuRules classic;
+    return classic;
+}
+
+template <int Order>
+BasicSuDoKuRules<Order>::BasicSuDoKuRules()
+    : unitCells(3 * kNumCells), regions(kNumCells), classicRegions(true),
+      extraUnits(kNumCells * kMaxExtraUnits, 0), numExtraUnits(kNumCells, 0), cages(kNumCells, -1) {
+    for (int unit = 0; unit < kDimension; unit++) {
+        int blockRow = unit / Order * Order, blockCol = unit % Order * Order;
+        for (int index = 0; index < kDimension; index++) {
+            unitCells[unit * kDimension + index] = unit * kDimension + index;
+            unitCells[(kDimension + unit) * kDimension + index] = index * kDimension + unit;
+            int cell = (blockRow + index / Order) * kDimension + blockCol + index % Order;
+            unitCells[(2 * kDimension + unit) * kDimension + index] = cell;
+            regions[cell] = unit;
+        }
+    }
+    findPeers();
+}
+
+/**
+ * Implementation notes: setRegions
+ * --------------------------------
+ * The regions are numbered in the order their symbols first appear, and
+ * are still the blocks, just numbered differently, if every location
+ * shares its symbol with the top left location of its block.
+ */
+template <int Order>
+bool BasicSuDoKuRules<Order>::setRegions(const string& layout) {
+    vector<string> symbols;
+    istringstream words(layout);
+    for (string word; words >> word; ) {
+        symbols.push_back(word);
+    }
+    if (symbols.size() == 1 && symbols[0].size() == size_t(kNumCells)) {
+        string compact = symbols[0];
+        symbols.clear();
+        for (char symbol: compact) {
+            symbols.push_back(string(1, symbol));
+        }
+    }
+    if (symbols.size() != size_t(kNumCells)) return false;
+
+    map<string, int> numbers;
+    vector<int> newRegions(kNumCells), sizes;
+    for (int cell = 0; cell < kNumCells; cell++) {
+        if (numbers.count(symbols[cell]) == 0) {
+            numbers[symbols[cell]] = sizes.size();
+            sizes.push_back(0);
+        }
+        newRegions[cell] = numbers[symbols[cell]];
+        sizes[newRegions[cell]]++;
+    }
+    if (sizes.size() != size_t(kDimension)) return false;
+    for (int size: sizes) {
+        if (size != kDimension) return false;
+    }
+
+    regions = newRegions;
+    classicRegions = true;
+    for (int region = 0; region < kDimension; region++) {
+        sizes[region] = 0;
+    }
+    for (int cell = 0; cell < kNumCells; cell++) {
+        int row = cell / kDimension, col = cell % kDimension;
+        int corner = row / Order * Order * kDimension + col / Order * Order;
+        if (regions[cell] != regions[corner]) classicRegions = false;
+        unitCells[(2 * kDimension + regions[cell]) * kDimension + sizes[regions[cell]]++] = cell;
+    }
+    findPeers();
+    return true;
+}
+
+/**
+ * Function: addUnits
+ * ------------------
+ * Adds all of the provided units or none of them, returning false in the
+ * latter case, so that addDiagonals and addWindows never add only some.
+ */
+template <int Order>
+static bool addUnits(const vector<vector<int> >& units, vector<int>& unitCells, vector<int16_t>& extraUnits,
+                     vector<int8_t>& numExtraUnits) {
+    const int kDimension = Order * Order, kNumCells = kDimension * kDimension;
+    const int kMaxExtraUnits = BasicSuDoKuRules<Order>::kMaxExtraUnits;
+    vector<int> numAdded(kNumCells, 0);
+    for (const vector<int>& cells: units) {
+        if (cells.size() != size_t(kDimension)) return false;
+        vector<bool> isListed(kNumCells, false);
+        for (int cell: cells) {
+            if (cell < 0 || cell >= kNumCells || isListed[cell]) return false;
+            isListed[cell] = true;
+            if (numExtraUnits[cell] + ++numAdded[cell] > kMaxExtraUnits) return false;
+        }
+    }
+
+    for (const vector<int>& cells: units) {
+        int extra = unitCells.size() / kDimension - 3 * kDimension;
+        for (int cell: cells) {
+            unitCells.push_back(cell);
+            extraUnits[cell * kMaxExtraUnits + numExtraUnits[cell]++] = extra;
+        }
+    }
+    return true;
+}
+
+template <int Order>
+bool BasicSuDoKuRules<Order>::addUnit(const vector<int>& cells) {
+    if (!addUnits<Order>(vector<vector<int> >(1, cells), unitCells, extraUnits, numExtraUnits)) return false;
+    findPeers();
+    return true;
+}
+
+template <int Order>
+bool BasicSuDoKuRules<Order>::addDiagonals() {
+    vector<vector<int> > diagonals(2);
+    for (int index = 0; index < kDimension; index++) {
+        diagonals[0].push_back(index * kDimension + index);
+        diagonals[1].push_back(index * kDimension + kDimension - 1 - index);
+    }
+    if (!addUnits<Order>(diagonals, unitCells, extraUnits, numExtraUnits)) return false;
+    findPeers();
+    return true;
+}
+
+template <int Order>
+bool BasicSuDoKuRules<Order>::addWindows() {
+    vector<vector<int> > windows;
+    for (int top = 1; top + Order < kDimension; top += Order + 1) {
+        for (int left = 1; left + Order < kDimension; left += Order + 1) {
+            vector<int> cells;
+            for (int index = 0; index < kDimension; index++) {
+                cells.push_back((top + index / Order) * kDimension + left + index % Order);
+            }
+            windows.push_back(cells);
+        }
+    }
+    if (!addUnits<Order>(windows, unitCells, extraUnits, numExtraUnits)) return false;
+    findPeers();
+    return true;
+}
+
+/**
+ * Function: findCombinations
+ * --------------------------
+ * Appends to combinations every mask of numDigits distinct digits, none
+ * smaller than lowest, that add up to sum, along with the digits already
+ * in chosen.  Returns false as soon as there are more than limit of them.
+ */
+static bool findCombinations(int lowest, int highest, int numDigits, int sum, uint64_t chosen,
+                             vector<uint64_t>& combinations, size_t limit) {
+    if (numDigits == 0) {
+        if (sum == 0) combinations.push_back(chosen);
+        return combinations.size() <= limit;
+    }
+    for (int digit = lowest; digit <= highest && digit * numDigits <= sum; digit++) {
+        if (!findCombinations(digit + 1, highest, numDigits - 1, sum - digit, chosen | (uint64_t(1) << (digit - 1)),
+                              combinations, limit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int Order>
+bool BasicSuDoKuRules<Order>::addCage(const vector<int>& cells, int sum) {
+    if (cells.empty() || cells.size() > size_t(kDimension)) return false;
+    vector<bool> isListed(kNumCells, false);
+    for (int cell: cells) {
+        if (cell < 0 || cell >= kNumCells || isListed[cell] || cages[cell] >= 0) return false;
+        isListed[cell] = true;
+    }
+    vector<uint64_t> combinations;
+    if (!findCombinations(1, kDimension, cells.size(), sum, 0, combinations, kMaxCageCombinations)) return false;
+    if (combinations.empty()) return false;
+
+    for (int cell: cells) {
+        cages[cell] = cageSums.size();
+    }
+    cageCells.push_back(cells);
+    cageSums.push_back(sum);
+    cageCombinations.push_back(combinations);
+    findPeers();
+    return true;
+}
+
+/**
+ * Function: readCell
+ * ------------------
+ * Reads a location written rNcM, returning false if the word isn't one.
+ */
+static bool readCell(const string& word, int dimension, int& cell) {
+    int row, col;
+    char r, c, extra;
+    istringstream in(word);
+    if (!(in >> r >> row >> c >> col) || in >> extra) return false;
+    if (tolower(r) != 'r' || tolower(c) != 'c') return false;
+    if (row < 1 || row > dimension || col < 1 || col > dimension) return false;
+    cell = (row - 1) * dimension + col - 1;
+    return true;
+}
+
+template <int Order>
+bool BasicSuDoKuRules<Order>::load(istream& in) {
+    string line;
+    while (getline(in, line)) {
+        istringstream words(line);
+        string keyword, rest;
+        if (!(words >> keyword) || keyword[0] == '#') continue;
+        if (keyword == "regions") {
+            getline(words, rest);
+            if (!setRegions(rest)) return false;
+        } else if (keyword == "diagonals") {
+            if (!addDiagonals()) return false;
+        } else if (keyword == "windows") {
+            if (!addWindows()) return false;
+        } else if (keyword == "unit" || keyword == "cage") {
+            int sum = 0;
+            if (keyword == "cage" && !(words >> sum)) return false;
+            vector<int> cells;
+            for (string word; words >> word; ) {
+                int cell;
+                if (!readCell(word, kDimension, cell)) return false;
+                cells.push_back(cell);
+            }
+            if (!(keyword == "unit" ? addUnit(cells) : addCage(cells, sum))) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Implementation notes: isLegal
+ * -----------------------------
+ * Checks the row, column, and region, then any other units, by walking
+ * their locations, and the cage by asking whether one of its combinations
+ * holds every digit already in it along with the new one.
+ */
+template <int Order>
+bool BasicSuDoKuRules<Order>::isLegal(const BasicSuDoKuBoard<Order>& board, int row, int col, int digit) const {
+    int cell = row * kDimension + col;
+    int units[3 + kMaxExtraUnits] = { row, kDimension + col, 2 * kDimension + regions[cell] };
+    int numUnits = 3;
+    for (int i = 0; i < numExtraUnits[cell]; i++) {
+        units[numUnits++] = 3 * kDimension + extraUnits[cell * kMaxExtraUnits + i];
+    }
+    for (int i = 0; i < numUnits; i++) {
+        const int *cells = getUnitCells(units[i]);
+        for (int index = 0; index < kDimension; index++) {
+            int other = cells[index];
+            if (other != cell && board[other / kDimension][other % kDimension] == digit) return false;
+        }
+    }
+
+    if (cages[cell] < 0) return true;
+    uint64_t digits = uint64_t(1) << (digit - 1);
+    for (int other: cageCells[cages[cell]]) {
+        int otherDigit = board[other / kDimension][other % kDimension];
+        if (other == cell || otherDigit == kEmpty) continue;
+        if (otherDigit == digit) return false;
+        digits |= uint64_t(1) << (otherDigit - 1);
+    }
+    for (uint64_t combination: cageCombinations[cages[cell]]) {
+        if ((combination & digits) == digits) return true;
+    }
+    return false;
+}
+
+/**
+ * Implementation notes: findPeers
+ * -------------------------------
+ * Rebuilt from scratch whenever a unit or cage is added, since that only
+ * happens while the rules are being set up.  Each location's units are
+ * listed first, so finding its peers only visits the locations it shares
+ * a unit or cage with, rather than every pair of locations.
+ */
+template <int Order>
+void BasicSuDoKuRules<Order>::findPeers() {
+    vector<vector<int> > units(kNumCells);
+    for (int unit = 0; unit < getNumUnits(); unit++) {
+        for (int index = 0; index < kDimension; index++) {
+            units[getUnitCells(unit)[index]].push_back(unit);
+        }
+    }
+
+    vector<int> lastSeen(kNumCells, -1);
+    peers.assign(kNumCells, vector<int>());
+    for (int cell = 0; cell < kNumCells; cell++) {
+        lastSeen[cell] = cell;
+        peers[cell].reserve(units[cell].size() * (kDimension - 1));
+        for (int unit: units[cell]) {
+            for (const int *other = getUnitCells(unit); other != getUnitCells(unit) + kDimension; other++) {
+                if (lastSeen[*other] == cell) continue;
+                lastSeen[*other] = cell;
+                peers[cell].push_back(*other);
+            }
+        }
+        if (cages[cell] >= 0) {
+            for (int other: cageCells[cages[cell]]) {
+                if (lastSeen[other] == cell) continue;
+                lastSeen[other] = cell;
+                peers[cell].push_back(other);
+            }
+        }
+        sort(peers[cell].begin(), peers[cell].end());
+    }
+}
+
+template class BasicSuDoKuRules<2>;
+template class BasicSuDoKuRules<3>;
+template class BasicSuDoKuRules<4>;
+template class BasicSuDoKuRules<5>;
+template class BasicSuDoKuRules<6>;
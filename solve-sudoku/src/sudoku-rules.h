@@ -0,0 +1,198 @@
+/**
+ * File: sudoku-rules.h
+ * --------------------
+ * Defines the BasicSuDoKuRules class template, which describes the
+ * constraints a SuDoKu board of some order has to satisfy as data rather
+ * than as code, so that the search in sudoku-solver.h can solve variants
+ * like jigsaw, X, windoku, and killer puzzles as well as classic ones.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "sudoku-board.h"
+#include "sudoku-constants.h"
+
+/**
+ * Class: BasicSuDoKuRules
+ * -----------------------
+ * Lists the units of a board, each a group of kDimension locations that
+ * must hold every digit exactly once, and its cages, each a smaller group
+ * of locations whose digits must all differ and add up to a given sum.
+ *
+ * The first kDimension units are always the rows, the next kDimension the
+ * columns, and the next kDimension the regions, which are the blocks
+ * unless setRegions lays them out otherwise, as in jigsaw puzzles.  Any
+ * further units, like the diagonals of X puzzles or the windows of windoku
+ * puzzles, follow.  Every cage lists the masks of digits (bit d - 1 for
+ * digit d) with exactly as many digits as it has locations that add up to
+ * its sum, so that which digits remain possible in a cage is a few
+ * bitwise operations rather than a search.  No location can be in more
+ * than kMaxExtraUnits units beyond its row, column, and region, or in more
+ * than one cage.
+ */
+template <int Order>
+class BasicSuDoKuRules {
+public:
+    static const int kDimension = Order * Order;
+    static const int kNumCells = kDimension * kDimension;
+    static const int kMaxExtraUnits = 4;
+    static const size_t kMaxCageCombinations = 1 << 16;
+
+    /**
+     * Method: getClassic
+     * ------------------
+     * Returns the rules of the classic puzzle: rows, columns, and blocks.
+     * They're only built the first time they're asked for, so the program
+     * never pays for the orders it doesn't solve.
+     */
+    static const BasicSuDoKuRules& getClassic();
+
+    /**
+     * Constructor: BasicSuDoKuRules
+     * -----------------------------
+     * Starts out with the rules of the classic puzzle.
+     */
+    BasicSuDoKuRules();
+
+    /**
+     * Method: setRegions
+     * ------------------
+     * Replaces the blocks with irregular regions, given as one symbol per
+     * location row by row, with the locations that share a symbol making up
+     * a region.  The symbols can be any characters other than spaces, or any
+     * words separated by spaces.  Returns false, leaving the rules as they
+     * were, unless there are exactly kDimension regions of kDimension
+     * locations each.
+     */
+    bool setRegions(const std::string& layout);
+
+    /**
+     * Methods: addUnit, addDiagonals, addWindows
+     * ------------------------------------------
+     * Add a unit of the kDimension provided locations, each given as
+     * row * kDimension + col; the two main diagonals, as in X puzzles; or
+     * the Order - 1 by Order - 1 windows of Order x Order locations that
+     * sit one location in from the blocks, as in windoku puzzles.  Each
+     * returns false, leaving the rules as they were, if a unit has the
+     * wrong number of locations, lists one twice, or gives some location
+     * too many units.
+     */
+    bool addUnit(const std::vector<int>& cells);
+    bool addDiagonals();
+    bool addWindows();
+
+    /**
+     * Method: addCage
+     * ---------------
+     * Adds a cage of the provided locations whose digits must add up to the
+     * sum.  Returns false, leaving the rules as they were, if some location
+     * is listed twice or is already in a cage, or if no digits could ever
+     * add up to the sum, or so many could that listing them would be
+     * impractical.
+     */
+    bool addCage(const std::vector<int>& cells, int sum);
+
+    /**
+     * Method: load
+     * ------------
+     * Reads rules from the stream, one per line, adding them to these ones:
+     *
+     *     regions <layout>            irregular regions, as for setRegions
+     *     diagonals                   the two main diagonals
+     *     windows                     the windoku windows
+     *     unit <cell> ...             a unit of kDimension locations
+     *     cage <sum> <cell> ...       a cage of locations adding up to sum
+     *
+     * Locations are written rNcM, counting rows and columns from 1, and
+     * blank lines and lines starting with '#' are skipped.  Returns false if
+     * some line can't be understood or its rule can't be added, in which
+     * case the rules on the lines before it have already been added.
+     */
+    bool load(std::istream& in);
+
+    /**
+     * Method: isClassic
+     * -----------------
+     * Returns true if and only if these are the rules of the classic puzzle,
+     * and hasClassicRegions returns true if the regions are the blocks,
+     * whatever units and cages have been added.
+     */
+    bool isClassic() const { return classicRegions && getNumUnits() == 3 * kDimension && cageSums.empty(); }
+    bool hasClassicRegions() const { return classicRegions; }
+
+    /**
+     * Method: isLegal
+     * ---------------
+     * Returns true if and only if the digit could go at (row, col) on the
+     * board without repeating a digit in any unit or cage, or making a cage
+     * impossible to complete.  Everything is checked from scratch.
+     */
+    bool isLegal(const BasicSuDoKuBoard<Order>& board, int row, int col, int digit) const;
+
+    /**
+     * Methods: getNumUnits, getUnitCells, getRegion
+     * ---------------------------------------------
+     * Return the number of units, the kDimension locations in the specified
+     * one, and the region holding the provided location, as a unit of its
+     * own numbered from 0.
+     */
+    int getNumUnits() const { return unitCells.size() / kDimension; }
+    const int *getUnitCells(int unit) const { return &unitCells[unit * kDimension]; }
+    int getRegion(int cell) const { return regions[cell]; }
+
+    /**
+     * Methods: getExtraUnits, getNumExtraUnits
+     * ----------------------------------------
+     * Return the units the location is in beyond its row, column, and
+     * region, numbered from 0 for unit 3 * kDimension, and how many of them
+     * there are.
+     */
+    const int16_t *getExtraUnits(int cell) const { return &extraUnits[cell * kMaxExtraUnits]; }
+    int getNumExtraUnits(int cell) const { return numExtraUnits[cell]; }
+
+    /**
+     * Methods: getNumCages, getCage, getCageCells, getCageSum, getCageCombinations
+     * ----------------------------------------------------------------------------
+     * Return the number of cages, the cage holding the provided location or
+     * -1 if there isn't one, and the locations, sum, and masks of digits
+     * that add up to the sum of the specified cage.
+     */
+    int getNumCages() const { return cageSums.size(); }
+    int getCage(int cell) const { return cages[cell]; }
+    const std::vector<int>& getCageCells(int cage) const { return cageCells[cage]; }
+    int getCageSum(int cage) const { return cageSums[cage]; }
+    const std::vector<uint64_t>& getCageCombinations(int cage) const { return cageCombinations[cage]; }
+
+    /**
+     * Method: getPeers
+     * ----------------
+     * Returns every other location that shares a unit or cage with the
+     * provided one, each exactly once.
+     */
+    const std::vector<int>& getPeers(int cell) const { return peers[cell]; }
+
+private:
+    std::vector<int> unitCells;                   // kDimension per unit
+    std::vector<int> regions;                     // by location
+    bool classicRegions;
+    std::vector<int16_t> extraUnits;              // kMaxExtraUnits per location
+    std::vector<int8_t> numExtraUnits;
+    std::vector<int> cages;                       // by location, or -1
+    std::vector<std::vector<int> > cageCells;
+    std::vector<int> cageSums;
+    std::vector<std::vector<uint64_t> > cageCombinations;
+    std::vector<std::vector<int> > peers;
+
+    void findPeers();
+};
+
+/**
+ * Type: SuDoKuRules
+ * -----------------
+ * The rules for the classic 9 x 9 board and its variants.
+ */
+typedef BasicSuDoKuRules<kBoardOrder> SuDoKuRules;
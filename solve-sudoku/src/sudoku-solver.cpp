@@ -0,0 +1,345 @@
+/**
+ * File: sudoku-solver.cpp
+ * -----------------------
+ * Presents the implementation of the functions the SuDoKu search relies on
+ * to decide what's legal, what's forced, and where to look next.  Each is
+ * a template on the order of the board, instantiated at the bottom of the
+ * file for every supported order, so the loop bounds below are all
+ * compile-time constants.
+ */
+
+#include "sudoku-solver.h"
+using namespace std;
+
+template <int Order>
+bool isLegal(const BasicSuDoKuBoard<Order>& board, int row, int col, int digit) {
+    const int kDimension = Order * Order;
+    for (int c = 0; c < kDimension; c++) {
+        if (board[row][c] == digit) return false;
+    }
+
+    for (int r = 0; r < kDimension; r++) {
+        if (board[r][col] == digit) return false;
+    }
+
+    int rowblock = row / Order;
+    int colblock = col / Order;
+    for (int drow = 0; drow < Order; drow++) {
+        for (int dcol = 0; dcol < Order; dcol++) {
+            if (board[Order * rowblock + drow][Order * colblock + dcol] == digit) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Implementation notes: BasicSuDoKuCandidates constructor
+ * -------------------------------------------------------
+ * Records the digits already on the board unit by unit first, and only
+ * then queues the unoccupied locations, if there's a queue to keep, so
+ * each is linked into its bucket once rather than moved every time one of
+ * its peers is filled in.  The
+ * masks for the other units and the cages are only allocated if the rules
+ * have any, and a cage can rule digits out before any are placed in it.
+ */
+template <int Order>
+BasicSuDoKuCandidates<Order>::BasicSuDoKuCandidates(const BasicSuDoKuBoard<Order>& board,
+                                                    const BasicSuDoKuRules<Order>& rules, bool withLocationQueue)
+    : consistent(true), rules(&rules), hasExtras(rules.getNumUnits() > 3 * kDimension || rules.getNumCages() > 0),
+      isQueued(withLocationQueue) {
+    for (int i = 0; i < kDimension; i++) {
+        rowDigits[i] = colDigits[i] = regionDigits[i] = 0;
+        for (int j = 0; j < kDimension; j++) {
+            excluded[i][j] = extraExcluded[i][j] = 0;
+            regions[i][j] = rules.getRegion(i * kDimension + j);
+        }
+    }
+    if (hasExtras) {
+        extraDigits.assign(rules.getNumUnits() - 3 * kDimension, 0);
+        cageDigits.assign(rules.getNumCages(), 0);
+        cageExclusions.assign(rules.getNumCages(), 0);
+        for (int cage = 0; cage < rules.getNumCages(); cage++) {
+            updateCageExclusions(cage);
+            for (int cell: rules.getCageCells(cage)) {
+                extraExcluded[cell / kDimension][cell % kDimension] = cageExclusions[cage];
+            }
+        }
+    }
+    for (int unit = 0; unit < 3 * kDimension; unit++) {
+        numEmpty[unit] = kDimension;
+    }
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            int digit = board[row][col];
+            if (digit == kEmpty) continue;
+            if (!isLegal(row, col, digit)) consistent = false;
+            rowDigits[row] |= getMask(digit);
+            colDigits[col] |= getMask(digit);
+            regionDigits[getRegion(row, col)] |= getMask(digit);
+            if (hasExtras) toggleExtraDigits(row * kDimension + col, digit);
+            numEmpty[row]--;
+            numEmpty[kDimension + col]--;
+            numEmpty[2 * kDimension + getRegion(row, col)]--;
+        }
+    }
+
+    if (!isQueued) return;
+    for (int key = 0; key <= kDimension; key++) {
+        firstCells[key] = -1;
+    }
+    lowestKey = kDimension;
+    for (int cell = kNumCells - 1; cell >= 0; cell--) {
+        int row = cell / kDimension, col = cell % kDimension;
+        keys[cell] = -1;
+        if (board[row][col] == kEmpty) link(cell, countDigits(getCandidates(row, col)));
+    }
+}
+
+/**
+ * Implementation notes: getFirstConstrained
+ * -----------------------------------------
+ * The lowest nonempty bucket is found by walking up from lowestKey, which
+ * only ever moves down when a location is linked into a lower bucket, so
+ * the walk is amortized over the moves that caused it.
+ */
+template <int Order>
+int BasicSuDoKuCandidates<Order>::getFirstConstrained() const {
+    while (lowestKey <= kDimension && firstCells[lowestKey] < 0) lowestKey++;
+    return lowestKey <= kDimension ? firstCells[lowestKey] : -1;
+}
+
+/**
+ * Function: findSingles
+ * ---------------------
+ * Appends every naked and hidden single to placements, returning false if
+ * the board has reached a contradiction.  options holds the options of
+ * every location, with 0 for occupied ones.  Within each unit, the digits
+ * that are options for at least one location and for at least two are
+ * accumulated as masks, so the digits with exactly one location fall out
+ * of a few bitwise operations.
+ */
+template <int Order>
+static bool findSingles(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                        const typename SuDoKuTraits<Order>::Mask *options, vector<SuDoKuPlacement>& placements) {
+    typedef typename SuDoKuTraits<Order>::Mask Mask;
+    const int kDimension = Order * Order;
+    for (int cell = 0; cell < kDimension * kDimension; cell++) {
+        Mask digits = options[cell];
+        if (digits == 0) {
+            if (board[cell / kDimension][cell % kDimension] == kEmpty) return false;
+        } else if ((digits & (digits - 1)) == 0) {
+            SuDoKuPlacement placement = { cell / kDimension, cell % kDimension, lowestDigit(digits) };
+            placements.push_back(placement);
+        }
+    }
+
+    const int numUnits = candidates.getRules().getNumUnits();
+    const int *unitCells = candidates.getRules().getUnitCells(0);
+    for (int unit = 0; unit < numUnits; unit++) {
+        const int *cells = unitCells + unit * kDimension;
+        Mask once = 0, twice = 0;
+        for (int index = 0; index < kDimension; index++) {
+            Mask digits = options[cells[index]];
+            twice |= once & digits;
+            once |= digits;
+        }
+        Mask missing = SuDoKuTraits<Order>::kAllDigits & ~candidates.getUnitDigits(unit);
+        if ((missing & ~once) != 0) return false;
+        Mask hidden = once & ~twice;
+        for (int index = 0; hidden != 0 && index < kDimension; index++) {
+            Mask digits = options[cells[index]] & hidden;
+            if (digits == 0) continue;
+            SuDoKuPlacement placement = { cells[index] / kDimension, cells[index] % kDimension,
+                                          lowestDigit(digits) };
+            placements.push_back(placement);
+            hidden &= ~digits;
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: excludeDigits
+ * -----------------------
+ * Rules the provided digits out at (row, col), provided the location is
+ * unoccupied and some of them are still options there, recording the
+ * change on the trail.
+ */
+template <int Order>
+static void excludeDigits(const BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+                          vector<BasicSuDoKuChange<Order> >& trail, int row, int col,
+                          typename SuDoKuTraits<Order>::Mask digits) {
+    if (board[row][col] != kEmpty || (candidates.getCandidates(row, col) & digits) == 0) return;
+    BasicSuDoKuChange<Order> change = { row, col, kEmpty, candidates.getExcluded(row, col) };
+    trail.push_back(change);
+    candidates.setExcluded(row, col, change.excluded | digits);
+}
+
+/**
+ * Function: lockCandidates
+ * ------------------------
+ * Applies the locked candidates rule along the rows, or along the columns
+ * if transposed is true, in which case line is a column and position is a
+ * row.  Each line is cut into Order segments, one per block it
+ * crosses, and segments[line][segment] holds the options of the locations
+ * in that segment.  A digit that, within a block, is an option on only one
+ * of its lines is ruled out of the rest of that line (pointing), and a digit
+ * that, within a line, is an option in only one of its segments is ruled
+ * out of the rest of that block (claiming).  The options may be out of date
+ * by the time the later lines are processed, but only ever by including
+ * digits already ruled out, and the rule stays sound for a superset.
+ */
+template <int Order>
+static void lockCandidates(const BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+                           const typename SuDoKuTraits<Order>::Mask *options,
+                           vector<BasicSuDoKuChange<Order> >& trail, bool transposed) {
+    typedef typename SuDoKuTraits<Order>::Mask Mask;
+    const int kDimension = Order * Order;
+    Mask segments[kDimension][Order];
+    for (int line = 0; line < kDimension; line++) {
+        for (int segment = 0; segment < Order; segment++) {
+            Mask digits = 0;
+            for (int position = segment * Order; position < (segment + 1) * Order; position++) {
+                int row = transposed ? position : line, col = transposed ? line : position;
+                digits |= options[row * kDimension + col];
+            }
+            segments[line][segment] = digits;
+        }
+    }
+
+    for (int line = 0; line < kDimension; line++) {
+        int band = line / Order * Order;
+        for (int segment = 0; segment < Order; segment++) {
+            Mask elsewhereInBlock = 0, elsewhereInLine = 0;
+            for (int other = 0; other < Order; other++) {
+                if (band + other != line) elsewhereInBlock |= segments[band + other][segment];
+                if (other != segment) elsewhereInLine |= segments[line][other];
+            }
+            Mask pointing = segments[line][segment] & ~elsewhereInBlock;
+            Mask claiming = segments[line][segment] & ~elsewhereInLine;
+            for (int position = 0; pointing != 0 && position < kDimension; position++) {
+                if (position / Order == segment) continue;
+                int row = transposed ? position : line, col = transposed ? line : position;
+                excludeDigits(board, candidates, trail, row, col, pointing);
+            }
+            for (int other = band; claiming != 0 && other < band + Order; other++) {
+                if (other == line) continue;
+                for (int position = segment * Order; position < (segment + 1) * Order; position++) {
+                    int row = transposed ? position : other, col = transposed ? other : position;
+                    excludeDigits(board, candidates, trail, row, col, claiming);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Function: deduce
+ * ----------------
+ * Gathers the options of every location once, and then looks for singles
+ * first, since they're cheap and fill in locations, and only falls back on
+ * locked candidates when there are none.  Note that kUseLockedCandidates
+ * can be set to true or false and everything will still work, since the
+ * rule only ever narrows the options.  Locked candidates are only looked
+ * for when the regions are the blocks, since the rule as implemented cuts
+ * lines into block-sized segments; any other units the rules have don't
+ * make it any less sound.
+ */
+static const bool kUseLockedCandidates = true;
+template <int Order>
+bool deduce(const BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+            vector<BasicSuDoKuChange<Order> >& trail, vector<SuDoKuPlacement>& placements,
+            bool withLockedCandidates) {
+    const int kDimension = Order * Order;
+    typename SuDoKuTraits<Order>::Mask options[kDimension * kDimension];
+    for (int row = 0; row < kDimension; row++) {
+        for (int col = 0; col < kDimension; col++) {
+            options[row * kDimension + col] =
+                board[row][col] == kEmpty ? candidates.getCandidates(row, col) : 0;
+        }
+    }
+
+    if (!findSingles(board, candidates, options, placements)) return false;
+    if (placements.empty() && kUseLockedCandidates && withLockedCandidates &&
+        candidates.getRules().hasClassicRegions()) {
+        lockCandidates(board, candidates, options, trail, false);
+        lockCandidates(board, candidates, options, trail, true);
+    }
+    return true;
+}
+
+/**
+ * Function: findBestEmptyLocation
+ * -------------------------------
+ * Searches all of the locations and surfaces the unoccuplied (row, col) location
+ * that is the most constrained.  The most constrained one can be argued to the
+ * the best location to address earlier rather than later.  Note that true is
+ * returned if a best location is eventually discovered, and false is returned
+ * if there are no unoccupied locations.  A location with no options at all
+ * ends the search right away, since nothing can be more constrained.
+ */
+template <int Order>
+static bool findBestEmptyLocation(const BasicSuDoKuBoard<Order>& board,
+                                  const BasicSuDoKuCandidates<Order>& candidates, int& row, int& col) {
+    const int kDimension = Order * Order;
+    int smallestNumOptions = kDimension + 1;
+    for (int r = 0; r < kDimension; r++) {
+        for (int c = 0; c < kDimension; c++) {
+            if (board[r][c] == kEmpty) {
+                int numOptions = countDigits(candidates.getCandidates(r, c));
+                if (numOptions < smallestNumOptions) {
+                    row = r;
+                    col = c;
+                    smallestNumOptions = numOptions;
+                    if (numOptions == 0) return true;
+                }
+            }
+        }
+    }
+
+    return smallestNumOptions <= kDimension;
+}
+
+/**
+ * Implementation notes: findLocation
+ * ----------------------------------
+ * Takes the first location in the lowest nonempty bucket if there's a
+ * queue to take it from, and otherwise rescans the board, which is quick
+ * now that counting a location's options is a population count.
+ */
+template <int Order>
+bool findLocation(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                  int& row, int& col, bool withLocationQueue) {
+    SuDoKuPhaseTimer timer(kChoosePhase);
+    if (!withLocationQueue || !candidates.hasLocationQueue()) {
+        return findBestEmptyLocation(board, candidates, row, col);
+    }
+    int cell = candidates.getFirstConstrained();
+    if (cell < 0) return false;
+    row = cell / (Order * Order);
+    col = cell % (Order * Order);
+    return true;
+}
+
+/**
+ * Macro: INSTANTIATE_SUDOKU_SOLVER
+ * --------------------------------
+ * Instantiates everything above that the header declares for the
+ * provided order.
+ */
+#define INSTANTIATE_SUDOKU_SOLVER(Order)                                                            \
+    template bool isLegal(const BasicSuDoKuBoard<Order>&, int, int, int);                           \
+    template class BasicSuDoKuCandidates<Order>;                                                    \
+    template bool deduce(const BasicSuDoKuBoard<Order>&, BasicSuDoKuCandidates<Order>&,             \
+                         vector<BasicSuDoKuChange<Order> >&, vector<SuDoKuPlacement>&, bool);       \
+    template bool findLocation(const BasicSuDoKuBoard<Order>&, const BasicSuDoKuCandidates<Order>&, \
+                               int&, int&, bool);
+
+INSTANTIATE_SUDOKU_SOLVER(2)
+INSTANTIATE_SUDOKU_SOLVER(3)
+INSTANTIATE_SUDOKU_SOLVER(4)
+INSTANTIATE_SUDOKU_SOLVER(5)
+INSTANTIATE_SUDOKU_SOLVER(6)
@@ -0,0 +1,813 @@
+/**
+ * File: sudoku-solver.h
+ * ---------------------
+ * Exports the recursive backtracking search for a solution to a SuDoKu
+ * puzzle, which is a Backtracker (see backtracking.h) run over the
+ * locations of the board.  solve is templated on the type of the display
+ * it reports its progress to, so the same search can animate a
+ * SuDoKuDisplay or run headless with one of the observers in
+ * sudoku-observers.h.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "backtracking.h"
+#include "parallel-backtracking.h"
+#include "sudoku-board.h"
+#include "sudoku-constants.h"
+#include "sudoku-observers.h"
+#include "sudoku-rules.h"
+#include "sudoku-stats.h"
+#include "sudoku-strategy.h"
+
+/**
+ * Class: SuDoKuTraits
+ * -------------------
+ * Chooses the smallest unsigned integer type with a bit for every digit of
+ * a board of the provided order to serve as its masks of digits, with
+ * bit d - 1 standing for digit d, so the classic board packs its masks
+ * into 16 bits and only the 36 x 36 board needs 64.
+ */
+template <int Order>
+struct SuDoKuTraits {
+    static const int kDimension = Order * Order;
+    typedef typename std::conditional<kDimension <= 8, uint8_t,
+            typename std::conditional<kDimension <= 16, uint16_t,
+            typename std::conditional<kDimension <= 32, uint32_t, uint64_t>::type>::type>::type Mask;
+    static const Mask kAllDigits = Mask((uint64_t(1) << kDimension) - 1);
+};
+
+/**
+ * Function: isLegal
+ * -----------------
+ * Brute force check that confirms whether it's okay to place the
+ * specific digit in the (row, col) location of the board without
+ * violating the rules, which are the classic ones unless others are
+ * provided.  The search relies on BasicSuDoKuCandidates instead, but this
+ * remains handy for checking a board from scratch.
+ */
+template <int Order>
+bool isLegal(const BasicSuDoKuBoard<Order>& board, int row, int col, int digit);
+template <int Order>
+bool isLegal(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuRules<Order>& rules, int row, int col,
+             int digit) {
+    return rules.isLegal(board, row, col, digit);
+}
+
+/**
+ * Function: lowestDigit
+ * ---------------------
+ * Returns the smallest digit in the provided mask of digits, which
+ * must be nonzero.
+ */
+inline int lowestDigit(uint64_t digits) {
+    return __builtin_ctzll(digits) + 1;
+}
+
+/**
+ * Function: countDigits
+ * ---------------------
+ * Returns the number of digits in the provided mask of digits.
+ */
+inline int countDigits(uint64_t digits) {
+    return __builtin_popcountll(digits);
+}
+
+/**
+ * Class: BasicSuDoKuCandidates
+ * ----------------------------
+ * Tracks which digits are already used in each row, column, and region of
+ * a board of the provided order as a mask with bit d - 1 set for digit d
+ * (see SuDoKuTraits), updated as the search places and lifts numbers.
+ * Whether a digit is legal is then a single AND, the number of options a
+ * cell has is a population count, and the digits worth trying are found by
+ * walking the set bits of a mask rather than by rescanning every unit per
+ * digit.  Each cell also has a mask of digits that propagation has ruled
+ * out there even though the rules alone allow them.
+ *
+ * The rules (see sudoku-rules.h) say which locations make up the regions,
+ * and what other units and cages there are.  The other units get masks of
+ * their own, and each cage a mask of the digits it rules out, which are
+ * the digits already in it and those in none of its combinations that
+ * hold them all.  What those masks rule out at each location is kept up
+ * to date as digits are placed and lifted, and each location's region is
+ * copied out of the rules up front, so finding the options at a location
+ * takes the same few lookups whatever the rules, and classic puzzles only
+ * pay for a branch when a digit is placed or lifted.
+ *
+ * Unless they're told not to, the candidates also keep the unoccupied
+ * locations in a bucket queue keyed by their number of options, so the
+ * most constrained ones are always in the lowest nonempty bucket, along
+ * with a count of the unoccupied locations in every row, column, and
+ * region.  Placing or lifting a digit moves the location and the peers
+ * that lose or regain the digit between buckets, and so does ruling
+ * digits out, which means undoing a change restores the queue along with
+ * everything else, and finding the most constrained location never
+ * rescans the board.
+ */
+template <int Order>
+class BasicSuDoKuCandidates {
+public:
+    typedef typename SuDoKuTraits<Order>::Mask Mask;
+    static const int kDimension = Order * Order;
+
+    /**
+     * Constructor: BasicSuDoKuCandidates
+     * ----------------------------------
+     * Records the digits already placed on the provided board, which is to
+     * be solved by the provided rules.  The rules must outlive the
+     * candidates.  If withLocationQueue is false, the queue isn't kept,
+     * which spares every placement the cost of moving peers between
+     * buckets when nothing is ever going to ask for them.
+     */
+    BasicSuDoKuCandidates(const BasicSuDoKuBoard<Order>& board,
+                          const BasicSuDoKuRules<Order>& rules = BasicSuDoKuRules<Order>::getClassic(),
+                          bool withLocationQueue = true);
+
+    /**
+     * Method: getRules
+     * ----------------
+     * Returns the rules the candidates follow.
+     */
+    const BasicSuDoKuRules<Order>& getRules() const { return *rules; }
+
+    /**
+     * Method: isConsistent
+     * --------------------
+     * Returns true if and only if no two of the digits on the board the
+     * candidates were constructed from break the rules, which is something
+     * the search itself never checks.
+     */
+    bool isConsistent() const { return consistent; }
+
+    /**
+     * Method: hasLocationQueue
+     * ------------------------
+     * Returns true if and only if the candidates keep the bucket queue of
+     * unoccupied locations.
+     */
+    bool hasLocationQueue() const { return isQueued; }
+
+    /**
+     * Method: getCandidates
+     * ---------------------
+     * Returns the mask of digits that could be placed at (row, col) without
+     * violating the rules.
+     */
+    Mask getCandidates(int row, int col) const {
+        Mask digits = rowDigits[row] | colDigits[col] | regionDigits[getRegion(row, col)] | excluded[row][col] |
+                      extraExcluded[row][col];
+        return SuDoKuTraits<Order>::kAllDigits & ~digits;
+    }
+
+    /**
+     * Method: isLegal
+     * ---------------
+     * Returns true if and only if the digit could be placed at (row, col)
+     * without violating the rules.
+     */
+    bool isLegal(int row, int col, int digit) const {
+        return (getCandidates(row, col) & getMask(digit)) != 0;
+    }
+
+    /**
+     * Methods: place, lift
+     * --------------------
+     * Record that the digit has been placed at or lifted from (row, col),
+     * which must be unoccupied or occupied by the digit, respectively.  Only
+     * the peers that lose or regain the digit as an option change buckets.
+     */
+    void place(int row, int col, int digit) {
+        if (isQueued) {
+            unlink(row * kDimension + col);
+            movePeers(row, col, digit, -1);
+            numEmpty[row]--;
+            numEmpty[kDimension + col]--;
+            numEmpty[2 * kDimension + getRegion(row, col)]--;
+        }
+        rowDigits[row] |= getMask(digit);
+        colDigits[col] |= getMask(digit);
+        regionDigits[getRegion(row, col)] |= getMask(digit);
+        if (hasExtras) toggleExtraDigits(row * kDimension + col, digit);
+        if (isQueued && hasExtras) requeueCage(row * kDimension + col);
+    }
+
+    void lift(int row, int col, int digit) {
+        rowDigits[row] &= ~getMask(digit);
+        colDigits[col] &= ~getMask(digit);
+        regionDigits[getRegion(row, col)] &= ~getMask(digit);
+        if (hasExtras) toggleExtraDigits(row * kDimension + col, digit);
+        if (isQueued) {
+            numEmpty[row]++;
+            numEmpty[kDimension + col]++;
+            numEmpty[2 * kDimension + getRegion(row, col)]++;
+            movePeers(row, col, digit, +1);
+            link(row * kDimension + col, countDigits(getCandidates(row, col)));
+            if (hasExtras) requeueCage(row * kDimension + col);
+        }
+    }
+
+    /**
+     * Methods: getExcluded, setExcluded
+     * ---------------------------------
+     * Get and set the mask of digits ruled out at (row, col) by propagation.
+     */
+    Mask getExcluded(int row, int col) const { return excluded[row][col]; }
+    void setExcluded(int row, int col, Mask digits) {
+        excluded[row][col] = digits;
+        int cell = row * kDimension + col;
+        if (isQueued && keys[cell] >= 0) {
+            unlink(cell);
+            link(cell, countDigits(getCandidates(row, col)));
+        }
+    }
+
+    /**
+     * Methods: getFirstConstrained, getNextConstrained
+     * ------------------------------------------------
+     * Walk the unoccupied locations with the fewest options, which are the
+     * ones in the lowest nonempty bucket, in no particular order.  The
+     * first returns the first of them, and the second the one after the
+     * provided one, both as row * Order * Order + col, and both return -1
+     * once there are no more.  Only the candidates that keep the queue can
+     * be walked.
+     */
+    int getFirstConstrained() const;
+    int getNextConstrained(int cell) const { return nextCells[cell]; }
+
+    /**
+     * Method: getEmptyCount
+     * ---------------------
+     * Returns the number of unoccupied locations in the specified row,
+     * column, or region, numbered as for getUnitDigits.  The counts are
+     * only kept up to date by the candidates that keep the queue.
+     */
+    int getEmptyCount(int unit) const { return numEmpty[unit]; }
+
+    /**
+     * Method: getUnitDigits
+     * ---------------------
+     * Returns the mask of digits already placed in the specified unit,
+     * numbered as the rules number them: the first kDimension units are the
+     * rows, the next kDimension the columns, the next kDimension the
+     * regions, and any others follow.
+     */
+    Mask getUnitDigits(int unit) const {
+        if (unit < kDimension) return rowDigits[unit];
+        if (unit < 2 * kDimension) return colDigits[unit - kDimension];
+        if (unit < 3 * kDimension) return regionDigits[unit - 2 * kDimension];
+        return extraDigits[unit - 3 * kDimension];
+    }
+
+    /**
+     * Method: getMask
+     * ---------------
+     * Returns the mask holding nothing but the provided digit.
+     */
+    static Mask getMask(int digit) { return Mask(Mask(1) << (digit - 1)); }
+
+private:
+    static const int kNumCells = kDimension * kDimension;
+
+    Mask rowDigits[kDimension];
+    Mask colDigits[kDimension];
+    Mask regionDigits[kDimension];
+    Mask excluded[kDimension][kDimension];
+    Mask extraExcluded[kDimension][kDimension];   // digits ruled out by the units beyond the regions, and by cages
+    uint8_t regions[kDimension][kDimension];
+    bool consistent;
+
+    const BasicSuDoKuRules<Order> *rules;
+    bool hasExtras;                       // whether there are units beyond the regions, or cages
+    std::vector<Mask> extraDigits;        // digits placed in each unit beyond the regions
+    std::vector<Mask> cageDigits;         // digits placed in each cage
+    std::vector<Mask> cageExclusions;     // digits each cage rules out in its unoccupied locations
+
+    bool isQueued;                        // whether the bucket queue and the counts below are kept
+    int16_t keys[kNumCells];              // each location's number of options, or -1 if it's occupied
+    int16_t nextCells[kNumCells];         // the buckets of locations by key, linked both ways
+    int16_t previousCells[kNumCells];
+    int16_t firstCells[kDimension + 1];   // the first location in each bucket, or -1
+    int16_t numEmpty[3 * kDimension];     // unoccupied locations per unit, numbered as for getUnitDigits
+    mutable int lowestKey;                // no bucket below this one holds a location
+
+    int getRegion(int row, int col) const { return regions[row][col]; }
+
+    /**
+     * Method: getExtraDigits
+     * ----------------------
+     * Returns the mask of digits ruled out at the location by the units it's
+     * in beyond its row, column, and region, and by its cage.
+     */
+    Mask getExtraDigits(int cell) const {
+        Mask digits = 0;
+        const int16_t *units = rules->getExtraUnits(cell);
+        for (int i = 0; i < rules->getNumExtraUnits(cell); i++) {
+            digits |= extraDigits[units[i]];
+        }
+        if (rules->getCage(cell) >= 0) digits |= cageExclusions[rules->getCage(cell)];
+        return digits;
+    }
+
+    /**
+     * Method: toggleExtraDigits
+     * -------------------------
+     * Adds the digit to the masks of the units the location is in beyond its
+     * row, column, and region, and to its cage, if it's being placed, or
+     * takes it out of them if it's being lifted, and then works out again
+     * which digits the cage rules out and which digits those units and the
+     * cage rule out in each of their locations.
+     */
+    void toggleExtraDigits(int cell, int digit) {
+        const int16_t *units = rules->getExtraUnits(cell);
+        for (int i = 0; i < rules->getNumExtraUnits(cell); i++) {
+            extraDigits[units[i]] ^= getMask(digit);
+        }
+        int cage = rules->getCage(cell);
+        if (cage >= 0) {
+            cageDigits[cage] ^= getMask(digit);
+            updateCageExclusions(cage);
+        }
+
+        for (int i = 0; i < rules->getNumExtraUnits(cell); i++) {
+            const int *cells = rules->getUnitCells(3 * kDimension + units[i]);
+            for (int index = 0; index < kDimension; index++) {
+                extraExcluded[cells[index] / kDimension][cells[index] % kDimension] = getExtraDigits(cells[index]);
+            }
+        }
+        if (cage < 0) return;
+        for (int other: rules->getCageCells(cage)) {
+            extraExcluded[other / kDimension][other % kDimension] = getExtraDigits(other);
+        }
+    }
+
+    /**
+     * Method: requeueCage
+     * -------------------
+     * Moves the unoccupied locations in the location's cage, if it has one,
+     * to the buckets they belong in, since a cage can rule out more digits
+     * than the one placed or lifted in it.
+     */
+    void requeueCage(int cell) {
+        if (rules->getCage(cell) < 0) return;
+        for (int other: rules->getCageCells(rules->getCage(cell))) {
+            if (keys[other] < 0) continue;
+            unlink(other);
+            link(other, countDigits(getCandidates(other / kDimension, other % kDimension)));
+        }
+    }
+
+    void updateCageExclusions(int cage) {
+        Mask possible = 0;
+        for (uint64_t combination: rules->getCageCombinations(cage)) {
+            if ((combination & cageDigits[cage]) == cageDigits[cage]) possible |= Mask(combination);
+        }
+        cageExclusions[cage] = cageDigits[cage] | (SuDoKuTraits<Order>::kAllDigits & ~possible);
+    }
+
+    /**
+     * Methods: link, unlink
+     * ---------------------
+     * Add a location to the bucket for the provided key, and remove it
+     * from its bucket.
+     */
+    void link(int cell, int key) {
+        keys[cell] = key;
+        previousCells[cell] = -1;
+        nextCells[cell] = firstCells[key];
+        if (firstCells[key] >= 0) previousCells[firstCells[key]] = cell;
+        firstCells[key] = cell;
+        if (key < lowestKey) lowestKey = key;
+    }
+
+    void unlink(int cell) {
+        if (keys[cell] < 0) return;
+        if (previousCells[cell] >= 0) nextCells[previousCells[cell]] = nextCells[cell];
+        else firstCells[keys[cell]] = nextCells[cell];
+        if (nextCells[cell] >= 0) previousCells[nextCells[cell]] = previousCells[cell];
+        keys[cell] = -1;
+    }
+
+    /**
+     * Method: movePeers
+     * -----------------
+     * Moves every unoccupied peer of (row, col) that has the digit as an
+     * option by delta buckets, which is -1 just before the digit is placed
+     * there and +1 just after it's lifted.
+     */
+    void movePeers(int row, int col, int digit, int delta) {
+        for (int peer: rules->getPeers(row * kDimension + col)) {
+            if (keys[peer] < 0 || (getCandidates(peer / kDimension, peer % kDimension) & getMask(digit)) == 0) continue;
+            int key = keys[peer];
+            unlink(peer);
+            link(peer, key + delta);
+        }
+    }
+};
+
+/**
+ * Type: SuDoKuCandidates
+ * ----------------------
+ * The candidates of the classic 9 x 9 board.
+ */
+typedef BasicSuDoKuCandidates<kBoardOrder> SuDoKuCandidates;
+
+/**
+ * Type: BasicSuDoKuChange
+ * -----------------------
+ * Records one change made by propagation, so that it can be undone when
+ * the search backtracks: either a digit deduced for (row, col), or, when
+ * digit is kEmpty, the digits excluded at (row, col) before more were.
+ * The search keeps these on a trail, and backtracking pops the changes
+ * made since the guess being taken back, which costs time in proportion
+ * to what was deduced rather than to the size of the board.
+ */
+template <int Order>
+struct BasicSuDoKuChange {
+    int row;
+    int col;
+    int digit;
+    typename SuDoKuTraits<Order>::Mask excluded;
+};
+
+typedef BasicSuDoKuChange<kBoardOrder> SuDoKuChange;
+
+/**
+ * Type: SuDoKuPlacement
+ * ---------------------
+ * Identifies a digit that must go in an unoccupied location.
+ */
+struct SuDoKuPlacement {
+    int row;
+    int col;
+    int digit;
+};
+
+/**
+ * Function: deduce
+ * ----------------
+ * Makes one sweep over the board in search of forced placements: naked
+ * singles (locations with only one option) and hidden singles (digits with
+ * only one possible location in some row, column, region, or other unit
+ * the rules have), all of which are appended to placements.  If there are
+ * none, and withLockedCandidates is true, locked candidates are looked for
+ * instead: a digit whose options within a block all lie on one row or
+ * column can't go elsewhere on that row or column, and vice versa, and any
+ * such exclusions are applied and pushed onto the trail.  Cages need no
+ * rule of their own, since the digits they rule out are already missing
+ * from the options.  Returns false if the board has reached a
+ * contradiction, which is to say that some location has no options or
+ * some unit has nowhere to put a missing digit.
+ */
+template <int Order>
+bool deduce(const BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+            std::vector<BasicSuDoKuChange<Order> >& trail, std::vector<SuDoKuPlacement>& placements,
+            bool withLockedCandidates = true);
+
+/**
+ * Function: findLocation
+ * ----------------------
+ * Surfaces an unoccupied (row, col) location with the fewest options,
+ * returning false if there are no unoccupied locations.  If the candidates
+ * keep the queue and withLocationQueue is true, it's the first location in
+ * the lowest nonempty bucket, and otherwise the board is rescanned for the
+ * first one on a tie.  This is where the search guesses unless it's handed
+ * a SuDoKuStrategy that orders its choices otherwise (see
+ * sudoku-strategy.h).
+ */
+template <int Order>
+bool findLocation(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                  int& row, int& col, bool withLocationQueue = true);
+
+/**
+ * Function: propagate
+ * -------------------
+ * Applies the placements surfaced by deduce, reporting each to the display
+ * and pushing each onto the trail, until deduce finds nothing more.
+ * Returns false as soon as a contradiction is reached, in which case the
+ * caller is expected to undo everything on the trail since it was called.
+ * withLockedCandidates is handed on to deduce, so that puzzles can be
+ * rated by whether singles alone get them anywhere.
+ */
+template <typename Display, int Order>
+bool propagate(Display& display, BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+               std::vector<BasicSuDoKuChange<Order> >& trail, bool withLockedCandidates = true) {
+    SuDoKuPhaseTimer timer(kPropagatePhase);
+    std::vector<SuDoKuPlacement> placements;
+    while (true) {
+        size_t trailSize = trail.size();
+        placements.clear();
+        SUDOKU_STATS(getSuDoKuStats().numSweeps++);
+        if (!deduce(board, candidates, trail, placements, withLockedCandidates)) return false;
+        if (placements.empty() && trail.size() == trailSize) return true;
+        for (const SuDoKuPlacement& placement: placements) {
+            int row = placement.row, col = placement.col, digit = placement.digit;
+            if (board[row][col] == digit) continue; // found as both a naked and a hidden single
+            if (board[row][col] != kEmpty || !candidates.isLegal(row, col, digit)) return false;
+            board[row][col] = digit;
+            candidates.place(row, col, digit);
+            BasicSuDoKuChange<Order> change = { row, col, digit, 0 };
+            trail.push_back(change);
+            display.provisionallyPlaceNumber(row, col, digit);
+        }
+    }
+}
+
+/**
+ * Function: undoChanges
+ * ---------------------
+ * Pops changes off the trail until only the first trailSize remain,
+ * lifting deduced digits from the board and display and restoring the
+ * exclusions they replaced.
+ */
+template <typename Display, int Order>
+void undoChanges(Display& display, BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+                 std::vector<BasicSuDoKuChange<Order> >& trail, size_t trailSize) {
+    SuDoKuPhaseTimer timer(kUndoPhase);
+    while (trail.size() > trailSize) {
+        const BasicSuDoKuChange<Order>& change = trail.back();
+        if (change.digit == kEmpty) {
+            candidates.setExcluded(change.row, change.col, change.excluded);
+        } else {
+            board[change.row][change.col] = kEmpty;
+            candidates.lift(change.row, change.col, change.digit);
+            display.liftNumber(change.row, change.col);
+        }
+        trail.pop_back();
+    }
+}
+
+/**
+ * Function: keepChanges
+ * ---------------------
+ * Reports the digits deduced by the changes on the trail from first up
+ * to (but not including) last as permanently placed.
+ */
+template <typename Display, int Order>
+void keepChanges(Display& display, const std::vector<BasicSuDoKuChange<Order> >& trail, size_t first,
+                 size_t last) {
+    for (size_t i = first; i < last; i++) {
+        if (trail[i].digit != kEmpty) display.permanentlyPlaceNumber(trail[i].row, trail[i].col);
+    }
+}
+
+/**
+ * Class: SuDoKuProblem
+ * --------------------
+ * Presents a board and its candidates to a Backtracker (see
+ * backtracking.h), whose variables are the locations, numbered row by row,
+ * and whose values are the digits.  Propagation runs on entering each
+ * node, the strategy decides where to guess and in which order to try the
+ * digits there, and a guess goes onto the trail like a deduced digit, so
+ * that undoing it is the same as undoing anything else.  Every digit
+ * placed, lifted, or kept is reported to the display.
+ */
+template <typename Display, int Order>
+class SuDoKuProblem {
+public:
+    static const int kDimension = Order * Order;
+    typedef int Variable;
+    typedef int Value;
+    struct Values {
+        int digits[kDimension];
+        int numDigits;
+        int next;
+    };
+    typedef std::vector<BasicSuDoKuChange<Order> > Trail;
+
+    SuDoKuProblem(Display& display, BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+                  SuDoKuStrategy& strategy) :
+        display(display), board(board), candidates(candidates), strategy(strategy) {}
+
+    bool propagate(Trail& trail) {
+        SUDOKU_STATS(getSuDoKuStats().numDeduced -= trail.size());
+        bool isPropagated = ::propagate(display, board, candidates, trail);
+        SUDOKU_STATS(getSuDoKuStats().numDeduced += trail.size());
+        return isPropagated;
+    }
+
+    bool chooseVariable(int& cell) {
+        int row, col;
+        if (!strategy.chooseLocation(board, candidates, row, col)) return false;
+        cell = row * kDimension + col;
+        return true;
+    }
+
+    Values getValues(int cell) {
+        Values values;
+        values.numDigits = strategy.orderDigits(board, candidates, cell / kDimension, cell % kDimension, values.digits);
+        values.next = 0;
+        SUDOKU_STATS(getSuDoKuStats().recordBranch(values.numDigits));
+        return values;
+    }
+
+    static bool nextValue(Values& values, int& digit) {
+        if (values.next == values.numDigits) return false;
+        digit = values.digits[values.next++];
+        return true;
+    }
+
+    void apply(int cell, int digit, Trail& trail) {
+        int row = cell / kDimension, col = cell % kDimension;
+        board[row][col] = digit;
+        candidates.place(row, col, digit);
+        BasicSuDoKuChange<Order> change = { row, col, digit, 0 };
+        trail.push_back(change);
+        display.provisionallyPlaceNumber(row, col, digit);
+    }
+
+    void undo(Trail& trail, size_t size) { undoChanges(display, board, candidates, trail, size); }
+    void keep(const Trail& trail, size_t first, size_t last) { keepChanges(display, trail, first, last); }
+
+private:
+    Display& display;
+    BasicSuDoKuBoard<Order>& board;
+    BasicSuDoKuCandidates<Order>& candidates;
+    SuDoKuStrategy& strategy;
+};
+
+/**
+ * Class: SuDoKuSearchObserver
+ * ---------------------------
+ * Counts a SuDoKuProblem's search into the calling thread's SuDoKuStats,
+ * and does nothing at all unless SUDOKU_ENABLE_STATS is defined.
+ */
+class SuDoKuSearchObserver {
+public:
+    void enterNode() { SUDOKU_STATS(getSuDoKuStats().numNodes++); }
+    void applyValue(int, int) { SUDOKU_STATS(getSuDoKuStats().descend()); }
+    void retractValue(int, int) {
+        SUDOKU_STATS(getSuDoKuStats().ascend());
+        SUDOKU_STATS(getSuDoKuStats().numBacktracks++);
+    }
+    void keepValue(int, int) { SUDOKU_STATS(getSuDoKuStats().ascend()); }
+    void recordSolution() {}
+};
+
+/**
+ * Function: solve
+ * ---------------
+ * Returns true if and only if the board represents a partial solution
+ * to some SuDoKu puzzle that can actually be solved.  If true is returned,
+ * the full solution is left within the board and presented in the view.
+ * Otherwise, false is returned and the board and display are left as they
+ * were when solve was called.  The Display type can be SuDoKuDisplay or
+ * any other class with the same provisionallyPlaceNumber,
+ * permanentlyPlaceNumber, and liftNumber methods.  The first version
+ * expects candidates that agree with the board, and keeps them in step
+ * with it.  Before every guess, propagation fills in whatever the guesses
+ * so far force, and the digits it deduces are reported to the display
+ * just like the guesses are.  The board can be of any supported order.
+ * With SUDOKU_ENABLE_STATS defined, the search also counts into the
+ * calling thread's SuDoKuStats (see sudoku-stats.h).  The strategy decides
+ * where to guess and in which order to try the digits there; without one,
+ * the search guesses where findLocation says to and tries the digits from
+ * smallest to largest.  The puzzle follows the classic rules unless the
+ * candidates, or the version taking a strategy, are handed others.  When
+ * a solution is found, the changes that led to it, guesses included, are
+ * left on the trail.
+ */
+template <typename Display, int Order>
+bool solve(Display& display, BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+           std::vector<BasicSuDoKuChange<Order> >& trail, SuDoKuStrategy& strategy) {
+    SuDoKuProblem<Display, Order> problem(display, board, candidates, strategy);
+    Backtracker<SuDoKuProblem<Display, Order>, SuDoKuSearchObserver> search(problem, trail);
+    return search.findFirst();
+}
+
+template <typename Display, int Order>
+bool solve(Display& display, BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+           std::vector<BasicSuDoKuChange<Order> >& trail) {
+    SuDoKuStrategy strategy;
+    return solve(display, board, candidates, trail, strategy);
+}
+
+template <typename Display, int Order>
+bool solve(Display& display, BasicSuDoKuBoard<Order>& board, SuDoKuStrategy& strategy,
+           const BasicSuDoKuRules<Order>& rules = BasicSuDoKuRules<Order>::getClassic()) {
+    BasicSuDoKuCandidates<Order> candidates(board, rules, strategy.usesLocationQueue());
+    if (!candidates.isConsistent()) return false;
+    std::vector<BasicSuDoKuChange<Order> > trail;
+    return solve(display, board, candidates, trail, strategy);
+}
+
+template <typename Display, int Order>
+bool solve(Display& display, BasicSuDoKuBoard<Order>& board) {
+    SuDoKuStrategy strategy;
+    return solve(display, board, strategy);
+}
+
+/**
+ * Function: solve
+ * ---------------
+ * Solves the puzzle on the board without reporting to anyone.
+ */
+template <int Order>
+bool solve(BasicSuDoKuBoard<Order>& board) {
+    NullSuDoKuObserver observer;
+    return solve(observer, board);
+}
+
+/**
+ * Function: solveInParallel
+ * -------------------------
+ * Solves the puzzle on the board just as solve does, but with numThreads
+ * threads sharing the search, or one per hardware thread if numThreads is
+ * 0.  Each thread works on its own copy of the board, the candidates, and
+ * the strategy, and nothing is reported to any display.  A puzzle with
+ * several solutions is left with whichever one a thread reaches first,
+ * unless isDeterministic is true, in which case it's left with the one
+ * solve would have found, provided the strategy isn't randomized.  With
+ * SUDOKU_ENABLE_STATS defined, each thread publishes its counters as it
+ * finishes (see sudoku-stats.h).
+ */
+template <int Order>
+bool solveInParallel(BasicSuDoKuBoard<Order>& board, int numThreads, const SuDoKuStrategy& strategy = SuDoKuStrategy(),
+                     const BasicSuDoKuRules<Order>& rules = BasicSuDoKuRules<Order>::getClassic(),
+                     bool isDeterministic = false) {
+    typedef SuDoKuProblem<NullSuDoKuObserver, Order> Problem;
+    BasicSuDoKuCandidates<Order> candidates(board, rules, strategy.usesLocationQueue());
+    if (!candidates.isConsistent()) return false;
+    if (numThreads <= 0) numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+
+    NullSuDoKuObserver display;
+    std::vector<BasicSuDoKuBoard<Order> > boards(numThreads, board);
+    std::vector<BasicSuDoKuCandidates<Order> > threadCandidates(numThreads, candidates);
+    std::vector<SuDoKuStrategy> strategies(numThreads, strategy);
+    std::vector<Problem> problems;
+    std::vector<Problem *> threadProblems;
+    problems.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        problems.push_back(Problem(display, boards[i], threadCandidates[i], strategies[i]));
+        threadProblems.push_back(&problems.back());
+    }
+
+    ParallelBacktracker<Problem, SuDoKuSearchObserver> search(threadProblems);
+    search.setDeterministic(isDeterministic);
+    SUDOKU_STATS(search.setThreadExitHook(publishSuDoKuStats));
+    if (!search.findFirst()) return false;
+    board = boards[0];
+    return true;
+}
+
+/**
+ * Function: countSolutions
+ * ------------------------
+ * Counts the solutions to the puzzle on the board, stopping as soon as
+ * limit of them have been found, so that a limit of 2 is all it takes to
+ * tell a puzzle with a unique solution from one with several.  The search
+ * is the same one solve runs, propagation included, except that it carries
+ * on past each solution it finds, undoing the changes back to the last
+ * guess rather than starting over.  The board, candidates, trail, and
+ * display are all left as they were when countSolutions was called,
+ * whatever the outcome, and nothing is ever permanently placed.  The first
+ * version adds the solutions it finds to numSolutions and returns true if
+ * and only if the limit was reached; the others return the number found,
+ * which is limit if there may be more.  The puzzle follows the classic
+ * rules unless the candidates, or the second version, are handed others.
+ */
+template <typename Display, int Order>
+bool countSolutions(Display& display, BasicSuDoKuBoard<Order>& board, BasicSuDoKuCandidates<Order>& candidates,
+                    std::vector<BasicSuDoKuChange<Order> >& trail, uint64_t limit, uint64_t& numSolutions) {
+    if (numSolutions >= limit) return true;
+    SuDoKuStrategy strategy;
+    SuDoKuProblem<Display, Order> problem(display, board, candidates, strategy);
+    Backtracker<SuDoKuProblem<Display, Order>, SuDoKuSearchObserver> search(problem, trail);
+    numSolutions += search.count(limit - numSolutions);
+    return numSolutions >= limit;
+}
+
+template <typename Display, int Order>
+uint64_t countSolutions(Display& display, BasicSuDoKuBoard<Order>& board, uint64_t limit,
+                        const BasicSuDoKuRules<Order>& rules = BasicSuDoKuRules<Order>::getClassic()) {
+    BasicSuDoKuCandidates<Order> candidates(board, rules);
+    if (!candidates.isConsistent() || limit == 0) return 0;
+    std::vector<BasicSuDoKuChange<Order> > trail;
+    uint64_t numSolutions = 0;
+    countSolutions(display, board, candidates, trail, limit, numSolutions);
+    return numSolutions;
+}
+
+template <int Order>
+uint64_t countSolutions(BasicSuDoKuBoard<Order>& board, uint64_t limit) {
+    NullSuDoKuObserver observer;
+    return countSolutions(observer, board, limit);
+}
+
+/**
+ * Function: hasUniqueSolution
+ * ---------------------------
+ * Returns true if and only if the puzzle on the board has exactly one
+ * solution, which is what makes it a proper puzzle.  The board is left
+ * as it was.
+ */
+template <int Order>
+bool hasUniqueSolution(BasicSuDoKuBoard<Order>& board) {
+    return countSolutions(board, 2) == 1;
+}
@@ -0,0 +1,89 @@
+/**
+ * File: sudoku-stats.cpp
+ * ----------------------
+ * Presents the implementation of the SuDoKu search counters.
+ */
+
+#include <algorithm>
+#include <mutex>
+#include "sudoku-stats.h"
+using namespace std;
+
+/* Globals */
+static mutex publishedLock;
+static SuDoKuStats published;
+
+void SuDoKuStats::reset() {
+    numNodes = numGuesses = numBacktracks = numSweeps = numDeduced = 0;
+    depth = maxDepth = 0;
+    fill(nanoseconds, nanoseconds + kNumPhases, 0);
+    branching.clear();
+}
+
+void SuDoKuStats::add(const SuDoKuStats& other) {
+    numNodes += other.numNodes;
+    numGuesses += other.numGuesses;
+    numBacktracks += other.numBacktracks;
+    numSweeps += other.numSweeps;
+    numDeduced += other.numDeduced;
+    maxDepth = max(maxDepth, other.maxDepth);
+    for (int phase = 0; phase < kNumPhases; phase++) {
+        nanoseconds[phase] += other.nanoseconds[phase];
+    }
+    if (branching.size() < other.branching.size()) branching.resize(other.branching.size());
+    for (size_t depth = 0; depth < other.branching.size(); depth++) {
+        vector<uint64_t>& counts = branching[depth];
+        const vector<uint64_t>& otherCounts = other.branching[depth];
+        if (counts.size() < otherCounts.size()) counts.resize(otherCounts.size());
+        for (size_t numOptions = 0; numOptions < otherCounts.size(); numOptions++) {
+            counts[numOptions] += otherCounts[numOptions];
+        }
+    }
+}
+
+void SuDoKuStats::recordBranch(int numOptions) {
+    if (branching.size() <= size_t(depth)) branching.resize(depth + 1);
+    vector<uint64_t>& counts = branching[depth];
+    if (counts.size() <= size_t(numOptions)) counts.resize(numOptions + 1);
+    counts[numOptions]++;
+}
+
+/**
+ * Implementation notes: print
+ * ---------------------------
+ * Each line of the histogram lists the number of nodes at that depth, the
+ * mean number of options at their chosen locations, and then the nonzero
+ * counts as options:count pairs.
+ */
+void SuDoKuStats::print(ostream& out) const {
+    out << "nodes " << numNodes << ", guesses " << numGuesses << ", backtracks " << numBacktracks
+        << ", sweeps " << numSweeps << ", deduced " << numDeduced << ", max depth " << maxDepth << endl;
+    out << "seconds propagating " << nanoseconds[kPropagatePhase] / 1e9 << ", choosing "
+        << nanoseconds[kChoosePhase] / 1e9 << ", undoing " << nanoseconds[kUndoPhase] / 1e9 << endl;
+    for (size_t depth = 0; depth < branching.size(); depth++) {
+        uint64_t numBranches = 0, numOptions = 0;
+        for (size_t options = 0; options < branching[depth].size(); options++) {
+            numBranches += branching[depth][options];
+            numOptions += options * branching[depth][options];
+        }
+        if (numBranches == 0) continue;
+        out << "depth " << depth << ": " << numBranches << " nodes, mean " << double(numOptions) / numBranches
+            << " options,";
+        for (size_t options = 0; options < branching[depth].size(); options++) {
+            if (branching[depth][options] != 0) out << ' ' << options << ':' << branching[depth][options];
+        }
+        out << endl;
+    }
+}
+
+void publishSuDoKuStats() {
+    SuDoKuStats& stats = getSuDoKuStats();
+    lock_guard<mutex> guard(publishedLock);
+    published.add(stats);
+    stats.reset();
+}
+
+SuDoKuStats getPublishedSuDoKuStats() {
+    lock_guard<mutex> guard(publishedLock);
+    return published;
+}
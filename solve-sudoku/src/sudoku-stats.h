@@ -0,0 +1,143 @@
+/**
+ * File: sudoku-stats.h
+ * --------------------
+ * Defines the counters that the SuDoKu search keeps about itself when the
+ * program is compiled with SUDOKU_ENABLE_STATS defined (with qmake, by
+ * adding CONFIG+=sudoku_stats).  Each thread counts into its own
+ * SuDoKuStats, so the counters cost a few increments and clock reads per
+ * node and never contend, and each thread publishes its counts into a
+ * process-wide total once it's done.  Without SUDOKU_ENABLE_STATS, the
+ * SUDOKU_STATS statements and phase timers compile away to nothing.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "stopwatch.h"
+
+/**
+ * Macro: SUDOKU_STATS
+ * -------------------
+ * Executes the provided statement only when statistics are compiled in.
+ */
+#ifdef SUDOKU_ENABLE_STATS
+#define SUDOKU_STATS(...) do { __VA_ARGS__; } while (false)
+static const bool kSuDoKuStatsEnabled = true;
+#else
+#define SUDOKU_STATS(...) do {} while (false)
+static const bool kSuDoKuStatsEnabled = false;
+#endif
+
+/**
+ * Type: SuDoKuPhase
+ * -----------------
+ * Identifies the parts of the search that are timed separately: applying
+ * deductions, choosing the location to guess at, and undoing changes.
+ */
+enum SuDoKuPhase {
+    kPropagatePhase,
+    kChoosePhase,
+    kUndoPhase,
+    kNumPhases
+};
+
+/**
+ * Class: SuDoKuStats
+ * ------------------
+ * Counts what the search did.  The depth of a node is the number of
+ * guesses made to reach it, and branching[depth][n] counts the nodes at
+ * that depth whose chosen location had n options, which shows where the
+ * search tree is bushy and where the ordering heuristics pay off.
+ */
+struct SuDoKuStats {
+    SuDoKuStats() { reset(); }
+
+    uint64_t numNodes;      // calls of the search, one per node of the tree
+    uint64_t numGuesses;    // digits tried at a chosen location
+    uint64_t numBacktracks; // guesses taken back
+    uint64_t numSweeps;     // sweeps made by deduce
+    uint64_t numDeduced;    // placements and exclusions made by propagation
+    int depth;              // guesses currently in progress
+    int maxDepth;           // the most guesses ever in progress at once
+    uint64_t nanoseconds[kNumPhases];
+    std::vector<std::vector<uint64_t> > branching;
+
+    /**
+     * Method: reset
+     * -------------
+     * Sets every counter back to zero.
+     */
+    void reset();
+
+    /**
+     * Method: add
+     * -----------
+     * Adds the other counters to these, taking the larger maximum depth.
+     */
+    void add(const SuDoKuStats& other);
+
+    /**
+     * Methods: recordBranch, descend, ascend
+     * --------------------------------------
+     * Record that a location with numOptions options was chosen at the
+     * current depth, and that a guess was made there or taken back.
+     */
+    void recordBranch(int numOptions);
+    void descend() {
+        numGuesses++;
+        if (++depth > maxDepth) maxDepth = depth;
+    }
+    void ascend() { depth--; }
+
+    /**
+     * Method: print
+     * -------------
+     * Prints the counters, the time spent in each phase, and the branching
+     * histogram, one line per depth.
+     */
+    void print(std::ostream& out) const;
+};
+
+/**
+ * Function: getSuDoKuStats
+ * ------------------------
+ * Returns the counters of the calling thread.
+ */
+inline SuDoKuStats& getSuDoKuStats() {
+    static thread_local SuDoKuStats stats;
+    return stats;
+}
+
+/**
+ * Functions: publishSuDoKuStats, getPublishedSuDoKuStats
+ * ------------------------------------------------------
+ * publishSuDoKuStats adds the calling thread's counters to the
+ * process-wide total and resets them, and should be called by every
+ * thread that searched before it exits.  getPublishedSuDoKuStats returns
+ * the total so far.
+ */
+void publishSuDoKuStats();
+SuDoKuStats getPublishedSuDoKuStats();
+
+/**
+ * Class: SuDoKuPhaseTimer
+ * -----------------------
+ * Adds the time between its construction and destruction to the calling
+ * thread's total for the provided phase.  Without SUDOKU_ENABLE_STATS,
+ * it's an empty class that does nothing at all.
+ */
+class SuDoKuPhaseTimer {
+public:
+#ifdef SUDOKU_ENABLE_STATS
+    SuDoKuPhaseTimer(SuDoKuPhase phase) : phase(phase) {}
+    ~SuDoKuPhaseTimer() { getSuDoKuStats().nanoseconds[phase] += stopwatch.getElapsedNanoseconds(); }
+
+private:
+    SuDoKuPhase phase;
+    Stopwatch stopwatch;
+#else
+    SuDoKuPhaseTimer(SuDoKuPhase) {}
+#endif
+};
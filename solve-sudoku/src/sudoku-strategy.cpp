@@ -0,0 +1,199 @@
+/**
+ * File: sudoku-strategy.cpp
+ * -------------------------
+ * Presents the implementation of the SuDoKuStrategy class.  Its choices
+ * are templates on the order of the board, instantiated at the bottom of
+ * the file for every supported order, just like the rest of the search.
+ */
+
+#include <algorithm>
+#include "sudoku-solver.h"
+#include "sudoku-strategy.h"
+using namespace std;
+
+/* Constants */
+static const char *const kOrderingNames[kNumOrderings] = {
+    "first-empty", "mrv", "mrv-degree", "mrv-scan", "mrv-random", "lcv"
+};
+
+const char *getOrderingName(SuDoKuOrdering ordering) {
+    return kOrderingNames[ordering];
+}
+
+bool findOrdering(const string& name, SuDoKuOrdering& ordering) {
+    for (int i = 0; i < kNumOrderings; i++) {
+        if (name == kOrderingNames[i]) {
+            ordering = SuDoKuOrdering(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+SuDoKuStrategy::SuDoKuStrategy(SuDoKuOrdering ordering, uint64_t seed)
+    : ordering(ordering), random(seed), numChoices(0) {}
+
+/**
+ * Function: findFirstEmptyLocation
+ * --------------------------------
+ * Surfaces the first unoccupied position on the board, returning true once
+ * row and col have been selected.  If there are no unoccupied locations, then
+ * false is returned to express failure.
+ */
+template <int Order>
+static bool findFirstEmptyLocation(const BasicSuDoKuBoard<Order>& board, int& row, int& col) {
+    for (row = 0; row < Order * Order; row++) {
+        for (col = 0; col < Order * Order; col++) {
+            if (board[row][col] == kEmpty) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Function: findBusiestLocation
+ * -----------------------------
+ * Surfaces the unoccupied location with the fewest options, breaking ties
+ * in favor of the one whose row, column, and region hold the most
+ * unoccupied locations, with the counts the candidates keep.  Only the
+ * lowest nonempty bucket of their queue is examined.  Counting the units
+ * separately counts a few peers twice, but the same few for every
+ * location, so the order is the same as counting peers.
+ */
+template <int Order>
+static bool findBusiestLocation(const BasicSuDoKuCandidates<Order>& candidates, int& row, int& col) {
+    const int kDimension = Order * Order;
+    int best = candidates.getFirstConstrained(), largestDegree = -1;
+    for (int cell = best; cell >= 0; cell = candidates.getNextConstrained(cell)) {
+        int r = cell / kDimension, c = cell % kDimension;
+        int region = candidates.getRules().getRegion(cell);
+        int degree = candidates.getEmptyCount(r) + candidates.getEmptyCount(kDimension + c) +
+                     candidates.getEmptyCount(2 * kDimension + region);
+        if (degree > largestDegree) {
+            best = cell;
+            largestDegree = degree;
+        }
+    }
+    if (best < 0) return false;
+    row = best / kDimension;
+    col = best % kDimension;
+    return true;
+}
+
+/**
+ * Function: findRandomLocation
+ * ----------------------------
+ * Surfaces one of the unoccupied locations with the fewest options, each
+ * as likely as the others, by keeping the kth one found with probability
+ * 1 / k as the board is scanned.
+ */
+template <int Order, typename Random>
+static bool findRandomLocation(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                               Random& random, int& row, int& col) {
+    const int kDimension = Order * Order;
+    int smallestNumOptions = kDimension + 1, numTied = 0;
+    for (int r = 0; r < kDimension; r++) {
+        for (int c = 0; c < kDimension; c++) {
+            if (board[r][c] != kEmpty) continue;
+            int numOptions = countDigits(candidates.getCandidates(r, c));
+            if (numOptions < smallestNumOptions) {
+                smallestNumOptions = numOptions;
+                numTied = 0;
+                if (numOptions == 0) {
+                    row = r;
+                    col = c;
+                    return true;
+                }
+            }
+            if (numOptions == smallestNumOptions &&
+                uniform_int_distribution<int>(0, numTied++)(random) == 0) {
+                row = r;
+                col = c;
+            }
+        }
+    }
+    return smallestNumOptions <= kDimension;
+}
+
+/**
+ * Implementation notes: chooseLocation
+ * ------------------------------------
+ * The default ordering goes straight to findLocation, so that the search
+ * takes the same path with a default strategy as it does without one, and
+ * so does the ordering that rescans the board.  Every other ordering is
+ * timed as choosing here instead.  Breaking ties by degree takes the
+ * queue, so candidates without one are left to findLocation.
+ */
+template <int Order>
+bool SuDoKuStrategy::chooseLocation(const BasicSuDoKuBoard<Order>& board,
+                                    const BasicSuDoKuCandidates<Order>& candidates, int& row, int& col) {
+    bool isFound;
+    if (ordering == kMostConstrainedOrdering || ordering == kLeastConstrainingOrdering ||
+        ordering == kRescanOrdering || (ordering == kDegreeOrdering && !candidates.hasLocationQueue())) {
+        isFound = findLocation(board, candidates, row, col, ordering != kRescanOrdering);
+    } else {
+        SuDoKuPhaseTimer timer(kChoosePhase);
+        switch (ordering) {
+            case kFirstEmptyOrdering: isFound = findFirstEmptyLocation(board, row, col); break;
+            case kDegreeOrdering: isFound = findBusiestLocation(candidates, row, col); break;
+            default: isFound = findRandomLocation(board, candidates, random, row, col); break;
+        }
+    }
+    if (isFound) numChoices++;
+    return isFound;
+}
+
+/**
+ * Implementation notes: orderDigits
+ * ---------------------------------
+ * Least constraining values are ranked by counting, for each option, the
+ * unoccupied peers that still have it as an option, and sorted stably so
+ * that ties stay in increasing order.
+ */
+template <int Order>
+int SuDoKuStrategy::orderDigits(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                                int row, int col, int digits[]) {
+    typedef typename SuDoKuTraits<Order>::Mask Mask;
+    const int kDimension = Order * Order;
+    int numDigits = 0;
+    for (Mask options = candidates.getCandidates(row, col); options != 0; options &= options - 1) {
+        digits[numDigits++] = lowestDigit(options);
+    }
+
+    if (ordering == kRandomizedOrdering) {
+        shuffle(digits, digits + numDigits, random);
+    } else if (ordering == kLeastConstrainingOrdering) {
+        int numConstrained[kDimension + 1] = { 0 };
+        for (int peer: candidates.getRules().getPeers(row * kDimension + col)) {
+            int r = peer / kDimension, c = peer % kDimension;
+            if (board[r][c] != kEmpty) continue;
+            for (Mask options = candidates.getCandidates(r, c) & candidates.getCandidates(row, col); options != 0;
+                 options &= options - 1) {
+                numConstrained[lowestDigit(options)]++;
+            }
+        }
+        stable_sort(digits, digits + numDigits, [&numConstrained](int one, int two) {
+            return numConstrained[one] < numConstrained[two];
+        });
+    }
+    return numDigits;
+}
+
+/**
+ * Macro: INSTANTIATE_SUDOKU_STRATEGY
+ * ----------------------------------
+ * Instantiates the strategy's choices for the provided order.
+ */
+#define INSTANTIATE_SUDOKU_STRATEGY(Order)                                                                        \
+    template bool SuDoKuStrategy::chooseLocation(const BasicSuDoKuBoard<Order>&,                                  \
+                                                 const BasicSuDoKuCandidates<Order>&, int&, int&);                \
+    template int SuDoKuStrategy::orderDigits(const BasicSuDoKuBoard<Order>&, const BasicSuDoKuCandidates<Order>&, \
+                                             int, int, int[]);
+
+INSTANTIATE_SUDOKU_STRATEGY(2)
+INSTANTIATE_SUDOKU_STRATEGY(3)
+INSTANTIATE_SUDOKU_STRATEGY(4)
+INSTANTIATE_SUDOKU_STRATEGY(5)
+INSTANTIATE_SUDOKU_STRATEGY(6)
@@ -0,0 +1,132 @@
+/**
+ * File: sudoku-strategy.h
+ * -----------------------
+ * Defines the SuDoKuStrategy class, which decides where the backtracking
+ * search of sudoku-solver.h guesses next and in which order it tries the
+ * digits there.  The ordering is chosen when the program runs rather than
+ * when it's compiled, since which one pays depends on the puzzles.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+template <int Order>
+class BasicSuDoKuBoard;
+template <int Order>
+class BasicSuDoKuCandidates;
+
+/**
+ * Type: SuDoKuOrdering
+ * --------------------
+ * Identifies the orderings a SuDoKuStrategy can follow:
+ *
+ *   - kFirstEmptyOrdering takes the first unoccupied location, row by row,
+ *     and tries its digits from smallest to largest.
+ *   - kMostConstrainedOrdering takes the location with the fewest options
+ *     (the minimum remaining values heuristic) from the candidates' bucket
+ *     queue, whichever comes first in its bucket on a tie, and tries its
+ *     digits from smallest to largest.  This is the default.
+ *   - kDegreeOrdering also takes a location with the fewest options from
+ *     the queue, but breaks ties in favor of the one whose row, column, and
+ *     region have the most unoccupied locations between them.
+ *   - kRescanOrdering rescans the board for the location with the fewest
+ *     options, the first one on a tie, rather than keep the queue, which
+ *     pays when propagation places many more digits than the search
+ *     guesses, as it does on most 9 x 9 puzzles.
+ *   - kRandomizedOrdering breaks ties among the locations with the fewest
+ *     options at random, and tries the digits in random order.
+ *   - kLeastConstrainingOrdering takes the same location as
+ *     kMostConstrainedOrdering, but tries first the digits that the fewest
+ *     of its unoccupied peers still have as an option.
+ */
+enum SuDoKuOrdering {
+    kFirstEmptyOrdering,
+    kMostConstrainedOrdering,
+    kDegreeOrdering,
+    kRescanOrdering,
+    kRandomizedOrdering,
+    kLeastConstrainingOrdering,
+    kNumOrderings
+};
+
+/**
+ * Functions: getOrderingName, findOrdering
+ * ----------------------------------------
+ * Translate between orderings and the names the command-line programs
+ * know them by: first-empty, mrv, mrv-degree, mrv-scan, mrv-random, and
+ * lcv.  findOrdering returns false if the name isn't one of them.
+ */
+const char *getOrderingName(SuDoKuOrdering ordering);
+bool findOrdering(const std::string& name, SuDoKuOrdering& ordering);
+
+/**
+ * Class: SuDoKuStrategy
+ * ---------------------
+ * Makes the choices the search leaves open, following one of the orderings
+ * above.  A strategy also counts the locations it has chosen, which is the
+ * number of nodes in the search tree that branch.  Randomized strategies
+ * draw from their own random number engine, so the same seed always leads
+ * to the same search.
+ */
+class SuDoKuStrategy {
+public:
+    SuDoKuStrategy(SuDoKuOrdering ordering = kMostConstrainedOrdering, uint64_t seed = 1);
+
+    /**
+     * Methods: getOrdering, reseed
+     * ----------------------------
+     * Return the ordering the strategy follows, and restart its random
+     * number engine from the provided seed.
+     */
+    SuDoKuOrdering getOrdering() const { return ordering; }
+    void reseed(uint64_t seed) { random.seed(seed); }
+
+    /**
+     * Method: usesLocationQueue
+     * -------------------------
+     * Returns true if and only if the strategy takes its locations from
+     * the candidates' bucket queue, so that the candidates it's handed are
+     * worth constructing with one (see BasicSuDoKuCandidates).
+     */
+    bool usesLocationQueue() const {
+        return ordering == kMostConstrainedOrdering || ordering == kDegreeOrdering ||
+               ordering == kLeastConstrainingOrdering;
+    }
+
+    /**
+     * Method: chooseLocation
+     * ----------------------
+     * Surfaces the unoccupied (row, col) location the search should guess at
+     * next, returning false if there are no unoccupied locations.
+     */
+    template <int Order>
+    bool chooseLocation(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                        int& row, int& col);
+
+    /**
+     * Method: orderDigits
+     * -------------------
+     * Fills digits with the options at the unoccupied (row, col) location in
+     * the order they should be tried, and returns how many there are.  digits
+     * must have room for Order * Order of them.
+     */
+    template <int Order>
+    int orderDigits(const BasicSuDoKuBoard<Order>& board, const BasicSuDoKuCandidates<Order>& candidates,
+                    int row, int col, int digits[]);
+
+    /**
+     * Methods: getChoiceCount, resetChoiceCount
+     * -----------------------------------------
+     * Get and reset the number of locations chosen so far.
+     */
+    uint64_t getChoiceCount() const { return numChoices; }
+    void resetChoiceCount() { numChoices = 0; }
+
+private:
+    SuDoKuOrdering ordering;
+    std::minstd_rand random;
+    uint64_t numChoices;
+};